@@ -0,0 +1,511 @@
+// Замеры парсеров и загрузки уровней без окна.
+//
+// GoldenLandEditorBench [--root <dir>] [--iterations <n>] [--levels <n>] [--cache]
+//                       [--json <file>] [--baseline <file>] [--threshold <percent>]
+//
+// Без --root замеряются только синтетические LVL и CS, сгенерированные во временном каталоге.
+// С --root дополнительно замеряются все SEF, SDB, MDF, CS, CSX и LVL игры и полная загрузка первых --levels уровней
+// через программный рендерер SDL. AssetCache по умолчанию выключен, чтобы замерять декодирование, а не кэш.
+// --baseline сравнивает files/s с прошлым результатом --json: падение больше --threshold процентов - код возврата 1
+#include <filesystem>
+#include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <string>
+#include <vector>
+#include <new>
+
+#include <SDL3/SDL.h>
+
+#include "graphics/AssetCache.h"
+#include "parsers/SEF_Parser.h"
+#include "parsers/LVL_Parser.h"
+#include "parsers/SDB_Parser.h"
+#include "parsers/MDF_Parser.h"
+#include "parsers/CSX_Parser.h"
+#include "parsers/CS_Parser.h"
+#include "enums/CsOpcodes.h"
+#include "utils/FileUtils.h"
+#include "Resources.h"
+#include "Level.h"
+
+// Счётчики выделений памяти через operator new. Выделения SDL и stb_image (malloc) сюда не попадают
+static std::atomic<uint64_t> g_allocations = 0;
+static std::atomic<uint64_t> g_allocatedBytes = 0;
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+struct Options {
+    std::string rootDirectory;
+    std::string jsonPath;
+    std::string baselinePath;
+    int iterations = 3;
+    int levels = 5;
+    double thresholdPercent = 10.0;
+    bool useCache = false;
+};
+
+struct BenchCase {
+    std::string name;
+    std::vector<std::string> inputs; // Пути к файлам, для загрузки уровней - имена уровней
+    bool inputsAreFiles = true;
+    std::function<bool(const std::string& input, std::string* error)> run;
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t files = 0;
+    uint64_t bytes = 0;
+    uint64_t failures = 0;
+    double seconds = 0.0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+
+    double filesPerSecond() const { return seconds > 0.0 ? files / seconds : 0.0; }
+    double megabytesPerSecond() const { return seconds > 0.0 ? bytes / seconds / (1024.0 * 1024.0) : 0.0; }
+};
+
+BenchResult runCase(const BenchCase& benchCase, int iterations)
+{
+    BenchResult result;
+    result.name = benchCase.name;
+
+    uint64_t inputBytes = 0;
+    if (benchCase.inputsAreFiles) {
+        for (const std::string& input : benchCase.inputs) {
+            std::error_code errorCode;
+            const auto size = std::filesystem::file_size(input, errorCode);
+            inputBytes += errorCode ? 0 : size;
+        }
+    }
+
+    std::string error;
+    std::string firstError;
+    const uint64_t allocationsBefore = g_allocations.load();
+    const uint64_t allocatedBytesBefore = g_allocatedBytes.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        for (const std::string& input : benchCase.inputs) {
+            if (!benchCase.run(input, &error)) {
+                if (firstError.empty()) {
+                    firstError = std::format("{}: {}", input, error);
+                }
+                ++result.failures;
+            }
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.allocations = (g_allocations.load() - allocationsBefore) / iterations;
+    result.allocatedBytes = (g_allocatedBytes.load() - allocatedBytesBefore) / iterations;
+    result.files = benchCase.inputs.size() * iterations;
+    result.bytes = inputBytes * iterations;
+
+    if (!firstError.empty()) {
+        std::fprintf(stderr, "[%s] %llu failures, first: %s\n", benchCase.name.c_str(),
+                     (unsigned long long)result.failures, firstError.c_str());
+    }
+    return result;
+}
+
+// Синтетические файлы: размеры близки к крупным уровням и скриптам игры
+std::vector<std::string> generateLvlFixtures(const std::filesystem::path& directory, int count)
+{
+    std::vector<std::string> paths;
+    for (int fileIndex = 0; fileIndex < count; ++fileIndex) {
+        LVL_Data data;
+        data.version = {2, 7};
+        data.mapSize = {7200, 5400};
+        data.mapTiles.chunkWidth = 300;
+        data.mapTiles.chunkHeight = 300;
+        data.mapTiles.resize(data.mapTiles.chunkWidth * data.mapTiles.chunkHeight);
+        for (size_t i = 0; i < data.mapTiles.tileCount(); ++i) {
+            data.mapTiles.relief[i] = static_cast<uint16_t>((i * 37 + fileIndex) % 60000);
+            data.mapTiles.sound[i] = static_cast<uint16_t>(i % 7);
+            data.mapTiles.mask[i] = (i % 11 == 0) ? static_cast<uint16_t>(i % 500) : MapTile::kEmptyMask;
+        }
+        for (uint32_t i = 0; i < 500; ++i) {
+            data.maskDescriptions.push_back({i, i * 13 % 7200, i * 7 % 5400});
+            data.staticDescriptions.push_back({std::format("static_{}", i), 0, 0, i, {int(i * 13 % 7200), int(i * 7 % 5400)}});
+        }
+        for (uint32_t i = 0; i < 100; ++i) {
+            data.animationDescriptions.push_back({std::format("anim_{}", i), 1, 2, i, {int(i * 71 % 7200), int(i * 53 % 5400)}});
+            data.triggerDescriptions.push_back({std::format("trigger_{}", i), 0, 0, i, {int(i * 31 % 7200), int(i * 17 % 5400)}});
+
+            CellGroup group;
+            group.name = std::format("group_{}", i);
+            for (int cell = 0; cell < 20; ++cell) {
+                group.cells.push_back({static_cast<uint16_t>(i * 5 + cell), static_cast<uint16_t>(i * 3 + cell)});
+            }
+            data.cellGroups.push_back(std::move(group));
+
+            ExtraSound sound;
+            sound.path = std::format("sounds/extra_{}.wav", i);
+            sound.chunkPositionX = float(i % 300);
+            sound.chunkPositionY = float(i % 300);
+            data.sounds.otherSounds.push_back(std::move(sound));
+        }
+
+        const std::string path = (directory / std::format("synthetic_{}.lvl", fileIndex)).string();
+        std::string error;
+        if (!LVL_Parser::save(path, data, &error)) {
+            std::fprintf(stderr, "LVL fixture error: %s\n", error.c_str());
+            continue;
+        }
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+std::vector<std::string> generateCsFixtures(const std::filesystem::path& directory, int count)
+{
+    std::vector<std::string> paths;
+    for (int fileIndex = 0; fileIndex < count; ++fileIndex) {
+        CS_Data data;
+        for (int i = 0; i < 20000; ++i) {
+            CS_Node node;
+            switch (i % 5) {
+                case 0:
+                    node.opcode = kLogicAnd;
+                    node.a = i + 1;
+                    node.b = i + 2;
+                    node.c = i + 3;
+                    node.d = i + 4;
+                    break;
+                case 1:
+                    node.opcode = kNumberLiteral;
+                    node.value = i * 0.5;
+                    break;
+                case 2:
+                    node.opcode = kStringLiteral;
+                    node.text = std::format("dialog_{}", i);
+                    break;
+                case 3:
+                    node.opcode = kFunc;
+                    node.c = i;
+                    node.d = -1;
+                    node.value = 12.0;
+                    node.args = {i - 2, i - 1, -1, -1, -1, -1, -1, -1, -1};
+                    break;
+                case 4:
+                    node.opcode = kJmp;
+                    node.c = i + 1;
+                    node.d = -1;
+                    break;
+            }
+            data.nodes.push_back(std::move(node));
+        }
+
+        const std::string path = (directory / std::format("synthetic_{}.cs", fileIndex)).string();
+        std::string error;
+        if (!CS_Parser::save(path, data, &error)) {
+            std::fprintf(stderr, "CS fixture error: %s\n", error.c_str());
+            continue;
+        }
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+// Уровни разбираются один раз до замера, замеряется только LVL_Parser::save
+BenchCase lvlSaveCase(std::string name, const std::vector<std::string>& lvlPaths, std::string savePath)
+{
+    auto levels = std::make_shared<std::unordered_map<std::string, LVL_Data>>();
+    std::vector<std::string> parsedPaths;
+    for (const std::string& path : lvlPaths) {
+        LVL_Data data;
+        std::string error;
+        if (!LVL_Parser::parse(path, data, &error)) {
+            std::fprintf(stderr, "[%s] %s skipped: %s\n", name.c_str(), path.c_str(), error.c_str());
+            continue;
+        }
+        levels->emplace(path, std::move(data));
+        parsedPaths.push_back(path);
+    }
+
+    return {std::move(name), std::move(parsedPaths), true, [levels, savePath = std::move(savePath)] (const std::string& path, std::string* error) {
+        return LVL_Parser::save(savePath, levels->at(path), error);
+    }};
+}
+
+std::vector<std::string> absolutePaths(std::string_view rootDirectory, const std::vector<std::string>& relativePaths)
+{
+    std::vector<std::string> result;
+    result.reserve(relativePaths.size());
+    for (const std::string& path : relativePaths) {
+        result.push_back(std::format("{}/{}", rootDirectory, path));
+    }
+    return result;
+}
+
+std::vector<BenchCase> gameCases(const Options& options, SDL_Renderer* renderer, const std::filesystem::path& tempDirectory)
+{
+    std::vector<BenchCase> cases;
+    const std::string& root = options.rootDirectory;
+    Resources resources(root);
+    ResourceFiles files = resources.files();
+
+    std::vector<std::string> levelNames = resources.levelNames(LevelType::kSingle);
+    std::vector<std::string> sefPaths;
+    std::vector<std::string> lvlPaths;
+    for (const std::string& levelName : levelNames) {
+        std::string sefPath = std::format("{0}/{1}.sef", Level::levelMainDir(root, "single", levelName), levelName);
+        char pack[32];
+        std::string error;
+        if (SEF_Parser::fastPackParse(sefPath, pack, &error)) {
+            lvlPaths.push_back(Level::levelLvl(root, pack));
+        }
+        sefPaths.push_back(std::move(sefPath));
+    }
+    std::sort(lvlPaths.begin(), lvlPaths.end());
+    lvlPaths.erase(std::unique(lvlPaths.begin(), lvlPaths.end()), lvlPaths.end());
+
+    cases.push_back({"SEF_Parser::parse", sefPaths, true, [] (const std::string& path, std::string* error) {
+        SEF_Data data;
+        return SEF_Parser::parse(path, data, error);
+    }});
+    cases.push_back({"LVL_Parser::parse", lvlPaths, true, [] (const std::string& path, std::string* error) {
+        LVL_Data data;
+        return LVL_Parser::parse(path, data, error);
+    }});
+    cases.push_back(lvlSaveCase("LVL_Parser::save", lvlPaths, (tempDirectory / "save.lvl").string()));
+    cases.push_back({"SDB_Parser::parse", absolutePaths(root, files.sdbFiles), true, [] (const std::string& path, std::string* error) {
+        SDB_Data data;
+        return SDB_Parser::parse(path, data, error);
+    }});
+    cases.push_back({"MDF_Parser::parse", absolutePaths(root, files.mdfFiles), true, [] (const std::string& path, std::string* error) {
+        return MDF_Parser::parse(path, error).has_value();
+    }});
+    cases.push_back({"CS_Parser::parse", absolutePaths(root, files.csFiles), true, [] (const std::string& path, std::string* error) {
+        CS_Data data;
+        return CS_Parser::parse(path, data, error);
+    }});
+    cases.push_back({"CSX_Parser::parse", absolutePaths(root, files.csxFiles), true, [] (const std::string& path, std::string* error) {
+        MappedFile file = FileUtils::mapFile(path, error);
+        if (!file)
+            return false;
+        CSX_Parser parser(file.data());
+        SurfacePtr surface(parser.parse(true, error));
+        return surface != nullptr;
+    }});
+
+    if (renderer && options.levels > 0) {
+        levelNames.resize(std::min<size_t>(levelNames.size(), options.levels));
+        cases.push_back({"Level::loadLevel", levelNames, false, [renderer, root] (const std::string& levelName, std::string* error) {
+            return Level::loadLevel(renderer, root, levelName, LevelType::kSingle, error).has_value();
+        }});
+    }
+    return cases;
+}
+
+void printResults(const std::vector<BenchResult>& results)
+{
+    std::printf("%-20s %8s %10s %10s %10s %12s %14s %8s\n",
+                "Benchmark", "Files", "Time, s", "Files/s", "MB/s", "Allocs/iter", "Alloc MB/iter", "Fails");
+    for (const BenchResult& result : results) {
+        std::printf("%-20s %8llu %10.3f %10.1f %10s %12llu %14.2f %8llu\n",
+                    result.name.c_str(),
+                    (unsigned long long)result.files,
+                    result.seconds,
+                    result.filesPerSecond(),
+                    result.bytes ? std::format("{:.1f}", result.megabytesPerSecond()).c_str() : "-",
+                    (unsigned long long)result.allocations,
+                    result.allocatedBytes / (1024.0 * 1024.0),
+                    (unsigned long long)result.failures);
+    }
+}
+
+// Одна запись на строку, чтобы сравнение с базовой линией обходилось без JSON-библиотеки
+std::string resultsToJson(const std::vector<BenchResult>& results)
+{
+    std::string json = "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        json += std::format("    {{\"name\": \"{}\", \"files\": {}, \"bytes\": {}, \"seconds\": {:.6f}, "
+                            "\"files_per_s\": {:.3f}, \"mb_per_s\": {:.3f}, \"allocations\": {}, \"allocated_bytes\": {}, \"failures\": {}}}{}\n",
+                            result.name, result.files, result.bytes, result.seconds,
+                            result.filesPerSecond(), result.megabytesPerSecond(),
+                            result.allocations, result.allocatedBytes, result.failures,
+                            i + 1 < results.size() ? "," : "");
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+std::string_view jsonField(std::string_view line, std::string_view key)
+{
+    const std::string pattern = std::format("\"{}\": ", key);
+    size_t pos = line.find(pattern);
+    if (pos == std::string_view::npos)
+        return {};
+    pos += pattern.size();
+    if (pos < line.size() && line[pos] == '"') {
+        const size_t end = line.find('"', pos + 1);
+        return line.substr(pos + 1, end - pos - 1);
+    }
+    const size_t end = line.find_first_of(",}", pos);
+    return line.substr(pos, end - pos);
+}
+
+// Падение files/s относительно базовой линии. true, если регрессий нет
+bool compareWithBaseline(const std::vector<BenchResult>& results, const std::string& baselinePath, double thresholdPercent)
+{
+    std::ifstream file(baselinePath);
+    if (!file) {
+        std::fprintf(stderr, "Can't open baseline: %s\n", baselinePath.c_str());
+        return false;
+    }
+
+    bool isOk = true;
+    std::string line;
+    std::printf("\nBaseline: %s (threshold %.1f%%)\n", baselinePath.c_str(), thresholdPercent);
+    while (std::getline(file, line)) {
+        const std::string_view name = jsonField(line, "name");
+        const std::string_view filesPerSecondText = jsonField(line, "files_per_s");
+        if (name.empty() || filesPerSecondText.empty())
+            continue;
+
+        double baselineFilesPerSecond = 0.0;
+        std::from_chars(filesPerSecondText.data(), filesPerSecondText.data() + filesPerSecondText.size(), baselineFilesPerSecond);
+        auto result = std::find_if(results.begin(), results.end(), [name] (const BenchResult& result) {
+            return result.name == name;
+        });
+        if (result == results.end() || baselineFilesPerSecond <= 0.0)
+            continue;
+
+        const double changePercent = (result->filesPerSecond() / baselineFilesPerSecond - 1.0) * 100.0;
+        const bool isRegression = changePercent < -thresholdPercent;
+        std::printf("%-20s %10.1f -> %10.1f files/s (%+.1f%%)%s\n",
+                    result->name.c_str(), baselineFilesPerSecond, result->filesPerSecond(), changePercent,
+                    isRegression ? "  REGRESSION" : "");
+        isOk = isOk && !isRegression;
+    }
+    return isOk;
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--root" && hasValue) {
+            options.rootDirectory = argv[++i];
+        } else if (arg == "--iterations" && hasValue) {
+            options.iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--levels" && hasValue) {
+            options.levels = std::atoi(argv[++i]);
+        } else if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--baseline" && hasValue) {
+            options.baselinePath = argv[++i];
+        } else if (arg == "--threshold" && hasValue) {
+            options.thresholdPercent = std::atof(argv[++i]);
+        } else if (arg == "--cache") {
+            options.useCache = true;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--root <dir>] [--iterations <n>] [--levels <n>] [--cache] "
+                                 "[--json <file>] [--baseline <file>] [--threshold <percent>]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    AssetCache::setEnabled(options.useCache);
+
+    std::error_code errorCode;
+    const std::filesystem::path tempDirectory = std::filesystem::temp_directory_path() / "GoldenLandEditorBench";
+    std::filesystem::create_directories(tempDirectory, errorCode);
+
+    std::vector<BenchCase> cases;
+    const std::vector<std::string> lvlFixtures = generateLvlFixtures(tempDirectory, 4);
+    cases.push_back({"LVL parse synthetic", lvlFixtures, true, [] (const std::string& path, std::string* error) {
+        LVL_Data data;
+        return LVL_Parser::parse(path, data, error);
+    }});
+    cases.push_back(lvlSaveCase("LVL save synthetic", lvlFixtures, (tempDirectory / "save_synthetic.lvl").string()));
+    cases.push_back({"CS parse synthetic", generateCsFixtures(tempDirectory, 4), true, [] (const std::string& path, std::string* error) {
+        CS_Data data;
+        return CS_Parser::parse(path, data, error);
+    }});
+
+    // Программный рендерер поверх поверхности в памяти: окно и видеодрайвер не нужны
+    SDL_Surface* targetSurface = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    if (!options.rootDirectory.empty()) {
+        targetSurface = SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_RGBA32);
+        renderer = targetSurface ? SDL_CreateSoftwareRenderer(targetSurface) : nullptr;
+        if (!renderer) {
+            std::fprintf(stderr, "Software renderer error: %s. Level::loadLevel skipped\n", SDL_GetError());
+        }
+
+        std::vector<BenchCase> rootCases = gameCases(options, renderer, tempDirectory);
+        std::move(rootCases.begin(), rootCases.end(), std::back_inserter(cases));
+    }
+
+    std::vector<BenchResult> results;
+    for (const BenchCase& benchCase : cases) {
+        if (benchCase.inputs.empty())
+            continue;
+        results.push_back(runCase(benchCase, options.iterations));
+    }
+    printResults(results);
+
+    if (!options.jsonPath.empty()) {
+        std::string json = resultsToJson(results);
+        std::string error;
+        if (!FileUtils::saveFile(options.jsonPath, {(const uint8_t*)json.data(), json.size()}, &error)) {
+            std::fprintf(stderr, "Can't save %s: %s\n", options.jsonPath.c_str(), error.c_str());
+        }
+    }
+
+    bool isOk = true;
+    if (!options.baselinePath.empty()) {
+        isOk = compareWithBaseline(results, options.baselinePath, options.thresholdPercent);
+    }
+
+    if (renderer)
+        SDL_DestroyRenderer(renderer);
+    if (targetSurface)
+        SDL_DestroySurface(targetSurface);
+    std::filesystem::remove_all(tempDirectory, errorCode);
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+// Тест всех диалоговых скриптов без окна, для CI.
+//
+// GoldenLandDialogTests --root <dir> [--threads <n>] [--json <file>]
+//
+// Код возврата 1, если хотя бы один скрипт завершился FatalError, не разобрался (IncorrectFormat)
+// или его обход остановлен лимитом состояний (LimitReached)
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
+#include <cstdio>
+#include <format>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/DialogTests.h"
+#include "utils/FileUtils.h"
+#include "Resources.h"
+
+namespace {
+
+std::string jsonQuoted(std::string_view text)
+{
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (c == '\n') {
+            result += "\\n";
+        } else {
+            result += c;
+        }
+    }
+    result += '"';
+    return result;
+}
+
+std::string resultsToJson(const std::vector<DialogTestResult>& results)
+{
+    std::string json = "{\n  \"dialogs\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const DialogTestResult& result = results[i];
+        json += std::format("    {{\"file\": {}, \"status\": {}, \"percent\": {:.2f}, \"covered_nodes\": {}, \"total_nodes\": {}, \"error\": {}}}{}\n",
+                            jsonQuoted(result.filepath), jsonQuoted(result.status), result.percent,
+                            result.coveredNodes, result.totalNodes, jsonQuoted(result.errorMessage),
+                            i + 1 < results.size() ? "," : "");
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string rootDirectory;
+    std::string jsonPath;
+    unsigned threadCount = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--root" && hasValue) {
+            rootDirectory = argv[++i];
+        } else if (arg == "--threads" && hasValue) {
+            threadCount = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else {
+            rootDirectory.clear();
+            break;
+        }
+    }
+    if (rootDirectory.empty()) {
+        std::fprintf(stderr, "Usage: %s --root <dir> [--threads <n>] [--json <file>]\n", argv[0]);
+        return 2;
+    }
+
+    Resources resources(rootDirectory);
+    std::vector<std::string> csFiles = resources.files().csFiles;
+    const size_t fileCount = csFiles.size();
+    auto globalVars = std::make_shared<const StringHashTable<AgeVariable_t>>(resources.globalVars());
+    if (globalVars->empty()) {
+        std::fprintf(stderr, "Global variables not found in %s\n", rootDirectory.c_str());
+        return 2;
+    }
+
+    DialogTestRunner runner;
+    runner.start(rootDirectory, std::move(csFiles), std::move(globalVars), threadCount);
+
+    // Результаты печатаются по мере готовности
+    std::vector<DialogTestResult> results;
+    results.reserve(fileCount);
+    size_t printed = 0;
+    bool isRunning = true;
+    while (isRunning) {
+        isRunning = runner.isRunning();
+        if (runner.takeResults(results) == 0) {
+            if (isRunning) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            continue;
+        }
+        for (; printed < results.size(); ++printed) {
+            const DialogTestResult& result = results[printed];
+            std::printf("[%zu/%zu] %-15s %6.2f%% %s\n", printed + 1, fileCount,
+                        result.status.c_str(), result.percent, result.filepath.c_str());
+            if (!result.errorMessage.empty()) {
+                std::printf("    %s\n", result.errorMessage.c_str());
+            }
+        }
+        std::fflush(stdout);
+    }
+    runner.wait();
+
+    std::sort(results.begin(), results.end(), [] (const DialogTestResult& a, const DialogTestResult& b) {
+        return a.filepath < b.filepath;
+    });
+
+    size_t failures = 0;
+    size_t coveredNodes = 0;
+    size_t totalNodes = 0;
+    for (const DialogTestResult& result : results) {
+        if (result.status == "FatalError" || result.status == "IncorrectFormat" || result.status == "LimitReached") {
+            ++failures;
+        }
+        coveredNodes += result.coveredNodes;
+        totalNodes += result.totalNodes;
+    }
+    std::printf("\nDialogs: %zu, failures: %zu, covered nodes: %zu / %zu (%.2f%%)\n",
+                results.size(), failures, coveredNodes, totalNodes,
+                totalNodes ? coveredNodes * 100.0 / totalNodes : 0.0);
+
+    if (!jsonPath.empty()) {
+        std::string json = resultsToJson(results);
+        std::string error;
+        if (!FileUtils::saveFile(jsonPath, {(const uint8_t*)json.data(), json.size()}, &error)) {
+            std::fprintf(stderr, "Can't save %s: %s\n", jsonPath.c_str(), error.c_str());
+        }
+    }
+    return failures > 0 ? 1 : 0;
+}
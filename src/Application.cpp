@@ -21,7 +21,6 @@
 #ifdef DEBUG_MENU_ENABLE
   #include <filesystem>
 
-  #include "CsExecutor.h"
   #include "utils/FileUtils.h"
   #include "utils/StringUtils.h"
   #include "utils/DialogTests.h"
@@ -150,11 +149,47 @@ void Application::initImGui(std::string_view fontFilepath, int fontSize) {
     style._NextFrameFontSizeBase = style.FontSizeBase;
 }
 
+bool Application::isLevelOpened(std::string_view levelName, LevelType levelType) const {
+    return std::any_of(m_rootDirContext.levels.cbegin(), m_rootDirContext.levels.cend(), [&] (const Level& level) {
+        return level.data().name == levelName && level.data().type == levelType;
+    });
+}
+
+// Загрузка уровня в фоне, текстуры создаются в mainLoop после декодирования.
+// Пока загружается другой уровень, запрос ставится в очередь
+void Application::requestLevel(std::string_view levelName, LevelType levelType) {
+    if (!m_levelLoader) {
+        m_levelLoader = std::make_unique<LevelLoader>(m_renderer, m_rootDirContext.rootDirectory(), levelName, levelType);
+        return;
+    }
+
+    if (m_levelLoader->levelName() == levelName && m_levelLoader->levelType() == levelType) {
+        return;
+    }
+    bool isQueued = std::any_of(m_levelQueue.cbegin(), m_levelQueue.cend(), [&] (const LevelRequest& request) {
+        return request.levelName == levelName && request.levelType == levelType;
+    });
+    if (!isQueued) {
+        m_levelQueue.push_back({std::string(m_rootDirContext.rootDirectory()), std::string(levelName), levelType});
+    }
+}
+
+void Application::loadNextQueuedLevel() {
+    while (!m_levelLoader && !m_levelQueue.empty()) {
+        LevelRequest request = std::move(m_levelQueue.front());
+        m_levelQueue.pop_front();
+        // Запросы к прежнему корневому каталогу устарели
+        if (request.rootDirectory == m_rootDirContext.rootDirectory() && !isLevelOpened(request.levelName, request.levelType)) {
+            requestLevel(request.levelName, request.levelType);
+        }
+    }
+}
+
 bool Application::hasActiveAnimations() const {
-    if (m_rootDirContext.isLoading()) {
+    if (m_rootDirContext.isLoading() || m_levelLoader) {
         return true;
     }
-    if (m_mdfViewer.isAnimating()) {
+    if (m_mdfViewer.isAnimating() || m_levelPicker.isLoadingPreview()) {
         return true;
     }
     for (const auto& level : m_rootDirContext.levels) {
@@ -165,6 +200,31 @@ bool Application::hasActiveAnimations() const {
     return false;
 }
 
+// Ближайшая смена кадра анимаций по всем уровням. 0 - ни одна видимая анимация не ждёт кадра
+uint64_t Application::nextAnimationFrameMs() const {
+    uint64_t nextFrameMs = 0;
+    for (const auto& level : m_rootDirContext.levels) {
+        const uint64_t levelFrameMs = m_levelViewer.nextAnimationFrameMs(level);
+        if (levelFrameMs != 0) {
+            nextFrameMs = nextFrameMs ? std::min(nextFrameMs, levelFrameMs) : levelFrameMs;
+        }
+    }
+    return nextFrameMs;
+}
+
+// Без событий цикл просыпается только к смене кадра анимаций, но не реже kWaitTimeoutMs
+int Application::eventWaitTimeoutMs() const {
+    const uint64_t nextFrameMs = nextAnimationFrameMs();
+    if (nextFrameMs == 0) {
+        return kWaitTimeoutMs;
+    }
+    const uint64_t nowMs = SDL_GetTicks();
+    if (nextFrameMs <= nowMs) {
+        return 0;
+    }
+    return (int)std::min<uint64_t>(nextFrameMs - nowMs, kWaitTimeoutMs);
+}
+
 void Application::mainLoop() {
     ImGuiIO& io = ImGui::GetIO();
     std::string uiError;
@@ -188,30 +248,31 @@ void Application::mainLoop() {
     bool showLevelsWindow = false;
     bool showSettingsWindow = false;
     bool showAboutWindow = false;
+    bool showTelemetryWindow = false;
 
 #ifdef DEBUG_MENU_ENABLE
-    struct TestResult {
-        std::string filepath;
-        std::string status;
-        std::string errorMessage;
-        float percent;
-    };
-    static std::vector<TestResult> testResults;
+    static std::vector<DialogTestResult> testResults;
+    DialogTestRunner dialogTestRunner;
 #endif
 
     while (!m_done)
     {
-        bool noWait = true;
+        int waitTimeoutMs = 0;
 #ifdef GOLDENLAND_FPS_LIMIT
-        noWait = (m_renderCooldown > 0);
+        if (m_renderCooldown == 0) {
+            waitTimeoutMs = eventWaitTimeoutMs();
+        }
 #endif
-        bool hasEvents = processEvents(noWait);
+        bool hasEvents = processEvents(waitTimeoutMs);
 
         if (ImGui::IsKeyPressed(ImGuiKey::ImGuiKey_F11, false)) {
             bool isFullscreen = SDL_GetWindowFlags(m_window) & SDL_WINDOW_FULLSCREEN;
             SDL_SetWindowFullscreen(m_window, !isFullscreen);
         }
 
+        // Списки ресурсов, опубликованные фоновой загрузкой, не меняются до следующего кадра
+        m_rootDirContext.acquireResources();
+
         // Start the Dear ImGui frame
         ImGui_ImplSDLRenderer3_NewFrame();
         ImGui_ImplSDL3_NewFrame();
@@ -219,8 +280,10 @@ void Application::mainLoop() {
 
         ImGuiID mainDockSpace = ImGui::DockSpaceOverViewport(0, ImGui::GetMainViewport());  
 
-        bool loaderWindow = m_rootDirContext.isLoading();
-        ImGuiWidgets::Loader("Loading...", loaderWindow);
+        // Загрузка корневого каталога не блокирует интерфейс: окна работают с уже загруженными списками
+        bool loaderWindow = (bool)m_levelLoader;
+        float loaderProgress = m_levelLoader ? m_levelLoader->progress() : -1.0f;
+        ImGuiWidgets::Loader("Loading...", loaderWindow, loaderProgress);
         ImGuiWidgets::ShowMessageModal("Error", uiError);
 
         if (ImGui::BeginMainMenuBar()) {
@@ -285,6 +348,9 @@ void Application::mainLoop() {
                 if (ImGui::MenuItem("Fullscreen", "F11", isFullscreen)) {
                     SDL_SetWindowFullscreen(m_window, !isFullscreen);
                 }
+#ifdef GOLDENLAND_TELEMETRY
+                ImGui::MenuItem("Telemetry", NULL, &showTelemetryWindow);
+#endif
 
                 ImGui::EndMenu();
             }
@@ -306,101 +372,9 @@ void Application::mainLoop() {
                 if (ImGui::MenuItem("Test all dialogs")) {
                     testResults.clear();
                     testResults.reserve(m_rootDirContext.csFiles().size());
-
-                    std::unordered_map<std::string, std::vector<DialogInstruction>> manualCases = getManualDialogTestData();
-                    for (const auto& csFile : m_rootDirContext.csFiles()) {
-                        std::string csError;
-                        CS_Data csData;
-
-                        std::string csPath = std::format("{}/{}", m_rootDirContext.rootDirectory(), csFile);
-                        LogFmt("Cs file processing: {}", csFile);
-                        bool isOkParse = CS_Parser::parse(csPath, csData, &csError);
-
-                        if (!isOkParse) {
-                            LogFmt("CS_Parser error: {}", csError);
-                            testResults.push_back({csFile, "IncorrectFormat", csError, 100.0f});
-                            continue;
-                        }
-
-                        CsExecutor executor(csData.nodes, m_rootDirContext.globalVars());
-                        if (auto it = manualCases.find(csFile); it != manualCases.end()) {
-                            const std::vector<DialogInstruction>& instructions = it->second;
-                            for (const auto& inst : instructions) {
-                                switch (inst.inst) {
-                                    case kExec: {
-                                        while (executor.next());
-                                        break;
-                                    }
-
-                                    case kUserInputAndExec: {
-                                        assert(executor.currentStatus() == CsExecutor::kWaitUser);
-                                        executor.userInput(inst.value);
-                                        while (executor.next());
-                                        break;
-                                    }
-
-                                    case kSetVariable: {
-                                        if (auto it = executor.scriptVars().find(inst.text); it != executor.scriptVars().end()) {
-                                            it->second = inst.value;
-                                        } else {
-                                            LogFmt("kSetVariable variable '{}' not found", inst.text);
-                                        }
-                                        break;
-                                    }
-
-                                    case kSoftRestart: {
-                                        executor.restart(false);
-                                        break;
-                                    }
-
-                                    case kHardRestart: {
-                                        executor.restart(true);
-                                        break;
-                                    }
-                                }
-                            }
-                            testResults.push_back({csFile, executor.currentStatusString(), {}, executor.executedPercent()});
-                        } else {
-                            // Алгоритм тестирования диалогов:
-                            // 1. Пытаемся прокликать первые варианты ответа
-                            //    Если попали в бесконечный цикл выбираем последний ответ и выходим
-                            // 2. Делаем 10 попыток проклика первых ответов после завершения диалога
-                            //    (Т.к. меняются переменные и возможны новые пути выполнения)
-                            try {
-                                float executedPercent = executor.executedPercent();
-                                uint8_t answer = 1;
-                                int tryCount = 10;
-
-                                while (tryCount) {
-                                    while (executor.currentStatus() != CsExecutor::kEnd
-                                           && executor.currentStatus() != CsExecutor::kInfinity)
-                                    {
-                                        while (executor.next()) {}
-
-                                        if (executedPercent == executor.executedPercent()) { // Прогресс остановился, вероятно попали в цикл
-                                            if (executor.dialogsAnswersCount() >= 2) {
-                                                answer = executor.dialogsAnswersCount();
-                                            } else {
-                                                answer = 1;
-                                            }
-                                        }
-
-                                        if (executor.currentStatus() == CsExecutor::kWaitUser) {
-                                            executor.userInput(answer);
-                                        }
-
-                                        executedPercent = executor.executedPercent();
-                                    }
-                                    executor.restart(false);
-                                    tryCount--;
-                                }
-
-                                testResults.push_back({csFile, executor.currentStatusString(), {}, executor.executedPercent()});
-                            } catch (const std::exception& ex) {
-                                testResults.push_back({csFile, "FatalError", ex.what(), 0.0f});
-                            }
-                        }
-                    }
+                    dialogTestRunner.start(m_rootDirContext.rootDirectory(),
+                                           m_rootDirContext.csFiles(),
+                                           m_rootDirContext.sharedGlobalVars());
                 }
 
                 ImGui::EndMenu();
@@ -415,127 +389,146 @@ void Application::mainLoop() {
                 ImGui::EndMenu();
             }
 
+            if (m_rootDirContext.isLoading()) {
+                ImGui::TextDisabled("Loading resources...");
+            }
+
             ImGui::EndMainMenuBar();
         }
 
-        if (!m_rootDirContext.isLoading()) {
-            if (m_rootDirContext.isEmptyContext()) {
-                ImGuiWindowFlags windowFlags = ImGuiWindowFlags_NoDecoration
-                    | ImGuiWindowFlags_AlwaysAutoResize
-                    | ImGuiWindowFlags_NoSavedSettings
-                    | ImGuiWindowFlags_NoFocusOnAppearing
-                    | ImGuiWindowFlags_NoNav
-                    | ImGuiWindowFlags_NoMove;
-
-                ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
-                ImGui::SetNextWindowBgAlpha(0.75f);
-                if (ImGui::Begin("##WarningEmptyRootContext", nullptr, windowFlags))
-                {
-                    ImGui::Text("Root folder not specified!\n"
-                                "Root folder is a directory with unpacked game resources\n"
-                                "(levels, scripts, etc.)\n"
-                                "\n"
-                                "Set it via 'Settings -> Set root folder...'\n"
-                                "\n"
-                                "Or edit settings.ini:\n"
-                                "[resources]\n"
-                                "root_dir = <path_to_root_folder>");
-                }
-                ImGui::End();
+        if (!m_rootDirContext.isLoading() && m_rootDirContext.isEmptyContext()) {
+            ImGuiWindowFlags windowFlags = ImGuiWindowFlags_NoDecoration
+                | ImGuiWindowFlags_AlwaysAutoResize
+                | ImGuiWindowFlags_NoSavedSettings
+                | ImGuiWindowFlags_NoFocusOnAppearing
+                | ImGuiWindowFlags_NoNav
+                | ImGuiWindowFlags_NoMove;
+
+            ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+            ImGui::SetNextWindowBgAlpha(0.75f);
+            if (ImGui::Begin("##WarningEmptyRootContext", nullptr, windowFlags))
+            {
+                ImGui::Text("Root folder not specified!\n"
+                            "Root folder is a directory with unpacked game resources\n"
+                            "(levels, scripts, etc.)\n"
+                            "\n"
+                            "Set it via 'Settings -> Set root folder...'\n"
+                            "\n"
+                            "Or edit settings.ini:\n"
+                            "[resources]\n"
+                            "root_dir = <path_to_root_folder>");
             }
+            ImGui::End();
+        }
 
-            ImGui::SetNextWindowDockID(mainDockSpace, ImGuiCond_FirstUseEver);
-            m_csxViewer.update(m_rootDirContext.showCsxWindow, m_renderer, m_rootDirContext.rootDirectory(), m_rootDirContext.csxFiles());
-            ImGui::SetNextWindowDockID(mainDockSpace, ImGuiCond_FirstUseEver);
-            m_sdbViewer.update(m_rootDirContext.showSdbWindow, m_rootDirContext.rootDirectory(), m_rootDirContext.sdbFiles());
-            ImGui::SetNextWindowDockID(mainDockSpace, ImGuiCond_FirstUseEver);
-            m_mdfViewer.update(m_rootDirContext.showMdfWindow, m_renderer, m_rootDirContext.rootDirectory(), m_rootDirContext.mdfFiles());
-            ImGui::SetNextWindowDockID(mainDockSpace, ImGuiCond_FirstUseEver);
-            m_csViewer.update(m_rootDirContext.showCsWindow, m_rootDirContext.rootDirectory(), m_rootDirContext.csFiles(),
-                              m_rootDirContext.dialogPhrases(), m_rootDirContext.globalVars());
-
-            if (showSettingsWindow) {
-                m_fontSettings->update(showSettingsWindow);
-            }
+        ImGui::SetNextWindowDockID(mainDockSpace, ImGuiCond_FirstUseEver);
+        m_csxViewer.update(m_rootDirContext.showCsxWindow, m_renderer, m_rootDirContext.textureCache(), m_rootDirContext.rootDirectory(), m_rootDirContext.csxFiles());
+        ImGui::SetNextWindowDockID(mainDockSpace, ImGuiCond_FirstUseEver);
+        m_sdbViewer.update(m_rootDirContext.showSdbWindow, m_rootDirContext.rootDirectory(), m_rootDirContext.sdbFiles());
+        ImGui::SetNextWindowDockID(mainDockSpace, ImGuiCond_FirstUseEver);
+        m_mdfViewer.update(m_rootDirContext.showMdfWindow, m_renderer, m_rootDirContext.textureCache(), m_rootDirContext.rootDirectory(), m_rootDirContext.mdfFiles());
+        ImGui::SetNextWindowDockID(mainDockSpace, ImGuiCond_FirstUseEver);
+        m_csViewer.update(m_rootDirContext.showCsWindow, m_rootDirContext.rootDirectory(), m_rootDirContext.csFiles(),
+                          m_rootDirContext.dialogPhrases(), m_rootDirContext.globalVars());
+
+        if (showSettingsWindow) {
+            m_fontSettings->update(showSettingsWindow);
+        }
 
-            if (showAboutWindow) {
-                showAboutWindow = ImGuiWidgets::ShowMessageModalEx("About", [&aboutMessage] () {
-                    ImGui::TextLinkOpenURL("GitHub repository", "https://github.com/DarkContact/GoldenLandEditor");
-                    ImGui::TextUnformatted(aboutMessage.data(), aboutMessage.data() + aboutMessage.size());
-                });
-            }
+        m_telemetryViewer.update(showTelemetryWindow, m_window);
+
+        if (showAboutWindow) {
+            showAboutWindow = ImGuiWidgets::ShowMessageModalEx("About", [&aboutMessage] () {
+                ImGui::TextLinkOpenURL("GitHub repository", "https://github.com/DarkContact/GoldenLandEditor");
+                ImGui::TextUnformatted(aboutMessage.data(), aboutMessage.data() + aboutMessage.size());
+            });
+        }
 
 #ifdef DEBUG_MENU_ENABLE
-            if (!testResults.empty()) {
-                if (ImGui::Begin("Dialog test result")) {
-                    int fatals = 0;
-                    int lowPercent = 0;
-                    float totalPercents = 0.0f;
-                    if (ImGui::BeginTable("Main Table", 2, ImGuiTableFlags_Borders)) {
-
-                        ImGui::TableSetupColumn("Dialog");
-                        ImGui::TableSetupColumn("Result");
-                        ImGui::TableHeadersRow();
-
-                        int id = 0;
-                        for (const auto& [filename, status, errorMessage, percent] : testResults) {
-                            ImGui::TableNextRow();
-
-                            ImGui::TableNextColumn();
-                            ImGui::TextUnformatted(filename.data(), filename.data() + filename.size());
-
-                            ImGui::PushID(id++);
-                            if (ImGui::BeginPopupContextItem("filename context menu")) {
-                                if (ImGui::MenuItem("Copy")) {
-                                    ImGui::SetClipboardText(filename.data());
-                                }
-                                if (ImGui::MenuItem("Explorer")) {
-                                    std::string dialogFile = std::format("{}/{}", m_rootDirContext.rootDirectory(), filename);
-                                    std::array<std::string_view, 1> files = {dialogFile};
-                                    std::string error;
-                                    std::filesystem::path dialogFilePath(StringUtils::toUtf8View(dialogFile));
-                                    if (!FileUtils::openFolderAndSelectItems(StringUtils::fromUtf8View(dialogFilePath.parent_path().u8string()), files, &error)) {
-                                        Log(error);
-                                    }
-                                }
-                                ImGui::EndPopup();
-                            }
-                            ImGui::PopID();
-
-                            ImGui::TableNextColumn();
-                            ImVec4 color(1.0f, 1.0f, 1.0f, 1.0f);
-                            if (percent == 0.0f) {
-                                color = ImVec4(0.98f, 0.0f, 0.0f, 1.0f);
-                                fatals++;
-                            } else if (percent <= 50.0f) {
-                                color = ImVec4(0.8f, 0.1f, 0.1f, 1.0f);
-                                lowPercent++;
-                            } else if (percent <= 75.0f) {
-                                color = ImVec4(0.9f, 0.9f, 0.1f, 1.0f);
-                            } else if (percent <= 100.0f) {
-                                color = ImVec4(0.1f, 0.9f, 0.1f, 1.0f);
+        dialogTestRunner.takeResults(testResults);
+        if (!testResults.empty() || dialogTestRunner.isRunning()) {
+            if (ImGui::Begin("Dialog test result")) {
+                if (dialogTestRunner.isRunning()) {
+                    ImGui::Text("Running: %zu / %zu", dialogTestRunner.processedCount(), dialogTestRunner.totalCount());
+                    ImGui::SameLine();
+                    if (ImGui::SmallButton("Cancel")) {
+                        dialogTestRunner.cancel();
+                    }
+                }
+
+                int fatals = 0;
+                int lowPercent = 0;
+                float totalPercents = 0.0f;
+                size_t coveredNodes = 0;
+                size_t totalNodes = 0;
+                if (ImGui::BeginTable("Main Table", 2, ImGuiTableFlags_Borders)) {
+
+                    ImGui::TableSetupColumn("Dialog");
+                    ImGui::TableSetupColumn("Result");
+                    ImGui::TableHeadersRow();
+
+                    int id = 0;
+                    for (const auto& [filename, status, errorMessage, percent, fileCoveredNodes, fileTotalNodes] : testResults) {
+                        ImGui::TableNextRow();
+
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(filename.data(), filename.data() + filename.size());
+
+                        ImGui::PushID(id++);
+                        if (ImGui::BeginPopupContextItem("filename context menu")) {
+                            if (ImGui::MenuItem("Copy")) {
+                                ImGui::SetClipboardText(filename.data());
                             }
-                            ImGui::TextColored(color, "%s", std::format("Status: {} ({:.2f} %)", status, percent).c_str());
-                            if (!errorMessage.empty()) {
-                                ImGui::Text("%s", errorMessage.c_str());
+                            if (ImGui::MenuItem("Explorer")) {
+                                std::string dialogFile = std::format("{}/{}", m_rootDirContext.rootDirectory(), filename);
+                                std::array<std::string_view, 1> files = {dialogFile};
+                                std::string error;
+                                std::filesystem::path dialogFilePath(StringUtils::toUtf8View(dialogFile));
+                                if (!FileUtils::openFolderAndSelectItems(StringUtils::fromUtf8View(dialogFilePath.parent_path().u8string()), files, &error)) {
+                                    Log(error);
+                                }
                             }
-
-                            totalPercents += percent;
+                            ImGui::EndPopup();
+                        }
+                        ImGui::PopID();
+
+                        ImGui::TableNextColumn();
+                        ImVec4 color(1.0f, 1.0f, 1.0f, 1.0f);
+                        if (percent == 0.0f) {
+                            color = ImVec4(0.98f, 0.0f, 0.0f, 1.0f);
+                            fatals++;
+                        } else if (percent <= 50.0f) {
+                            color = ImVec4(0.8f, 0.1f, 0.1f, 1.0f);
+                            lowPercent++;
+                        } else if (percent <= 75.0f) {
+                            color = ImVec4(0.9f, 0.9f, 0.1f, 1.0f);
+                        } else if (percent <= 100.0f) {
+                            color = ImVec4(0.1f, 0.9f, 0.1f, 1.0f);
+                        }
+                        ImGui::TextColored(color, "%s", std::format("Status: {} ({:.2f} %)", status, percent).c_str());
+                        if (!errorMessage.empty()) {
+                            ImGui::Text("%s", errorMessage.c_str());
                         }
-                        ImGui::EndTable();
-                    }
 
-                    ImGui::Text("Total percents: %.2f / %.2f (%.2f %%)", totalPercents, testResults.size() * 100.0f,
-                                (totalPercents / (testResults.size() * 100.0f)) * 100.0f);
-                    ImGui::Separator();
-                    ImGui::Text("Total: %zu", testResults.size());
-                    ImGui::Text("Fatals: %d", fatals);
-                    ImGui::Text("Low percent: %d", lowPercent);
+                        totalPercents += percent;
+                        coveredNodes += fileCoveredNodes;
+                        totalNodes += fileTotalNodes;
+                    }
+                    ImGui::EndTable();
                 }
-                ImGui::End();
+
+                ImGui::Text("Total percents: %.2f / %.2f (%.2f %%)", totalPercents, testResults.size() * 100.0f,
+                            testResults.empty() ? 0.0f : (totalPercents / (testResults.size() * 100.0f)) * 100.0f);
+                ImGui::Text("Covered nodes: %zu / %zu (%.2f %%)", coveredNodes, totalNodes,
+                            totalNodes ? (coveredNodes * 100.0 / totalNodes) : 0.0);
+                ImGui::Separator();
+                ImGui::Text("Total: %zu", testResults.size());
+                ImGui::Text("Fatals: %d", fatals);
+                ImGui::Text("Low percent: %d", lowPercent);
             }
-#endif
+            ImGui::End();
         }
+#endif
 
         // NOTE: Для генерации озвучки
         // static bool csViewerOnce = false;
@@ -547,48 +540,50 @@ void Application::mainLoop() {
         if (showLevelsWindow && !m_rootDirContext.singleLevelNames().empty()) {
             if (auto result = m_levelPicker.update(showLevelsWindow,
                                                    m_renderer,
+                                                   m_rootDirContext.textureCache(),
                                                    m_rootDirContext.rootDirectory(),
                                                    m_rootDirContext.singleLevelNames(),
                                                    m_rootDirContext.multiplayerLevelNames(),
                                                    m_rootDirContext.levelHumanNamesDict(),
                                                    m_rootDirContext.selectedLevelIndex); result.selected) {
-                bool alreadyLoaded = false;
-                for (const auto& level : m_rootDirContext.levels) {
-                    if (level.data().name == result.loadedLevelName && level.data().type == result.loadedLevelType) {
-                        alreadyLoaded = true;
-                        break;
-                    }
-                }
-
-                if (alreadyLoaded) {
+                if (isLevelOpened(result.loadedLevelName, result.loadedLevelType)) {
                     ImGui::SetWindowFocus(Level::levelWindowName(result.loadedLevelName, result.loadedLevelType).c_str());
                 } else {
-                    // Загрузка уровня
-                    std::string error;
-                    auto level = Level::loadLevel(m_renderer, m_rootDirContext.rootDirectory(), result.loadedLevelName, result.loadedLevelType, &error);
-                    if (level) {
-                        m_rootDirContext.levels.push_back(std::move(*level));
-                    } else {
-                        uiError = std::move(error);
-                    }
+                    requestLevel(result.loadedLevelName, result.loadedLevelType);
                 }
             }
         }
 
-        if (!m_rootDirContext.isLoading()) {
-            for (auto it = m_rootDirContext.levels.begin(); it != m_rootDirContext.levels.end();) {
-                bool openLevel = true;
-                Level& level = *it;
-                if (level.data().background) {
-                    ImGui::SetNextWindowDockID(mainDockSpace, ImGuiCond_FirstUseEver);
-                    m_levelViewer.update(openLevel, m_rootDirContext.rootDirectory(), level);
-                    if (!openLevel) {
-                        it = m_rootDirContext.levels.erase(it);
-                        continue;
-                    }
+        // Корневой каталог сменился: уровень прежней игры нельзя открывать с новыми ресурсами
+        if (m_levelLoader && m_levelLoader->rootDirectory() != m_rootDirContext.rootDirectory()) {
+            m_levelLoader.reset();
+            m_levelQueue.clear();
+        }
+
+        if (m_levelLoader && m_levelLoader->isDecoded()) {
+            std::string error;
+            auto level = m_levelLoader->finish(m_renderer, &error);
+            if (level) {
+                m_rootDirContext.levels.push_back(std::move(*level));
+            } else {
+                uiError = std::move(error);
+            }
+            m_levelLoader.reset();
+            loadNextQueuedLevel();
+        }
+
+        for (auto it = m_rootDirContext.levels.begin(); it != m_rootDirContext.levels.end();) {
+            bool openLevel = true;
+            Level& level = *it;
+            if (level.data().background) {
+                ImGui::SetNextWindowDockID(mainDockSpace, ImGuiCond_FirstUseEver);
+                m_levelViewer.update(openLevel, m_renderer, m_rootDirContext.rootDirectory(), level);
+                if (!openLevel) {
+                    it = m_rootDirContext.levels.erase(it);
+                    continue;
                 }
-                ++it;
             }
+            ++it;
         }
 
 #ifdef GOLDENLAND_FPS_LIMIT
@@ -603,10 +598,10 @@ void Application::mainLoop() {
     }
 }
 
-bool Application::processEvents(bool noWait) {
+bool Application::processEvents(int waitTimeoutMs) {
     SDL_Event event;
-    bool hasEvent = noWait ? SDL_PollEvent(&event)
-                           : SDL_WaitEventTimeout(&event, kWaitTimeoutMs);
+    bool hasEvent = (waitTimeoutMs == 0) ? SDL_PollEvent(&event)
+                                         : SDL_WaitEventTimeout(&event, waitTimeoutMs);
 
     bool hasEvents = hasEvent;
     while (hasEvent) {
@@ -1,8 +1,12 @@
 #pragma once
 #include <string_view>
 #include <optional>
+#include <memory>
+#include <string>
+#include <deque>
 
 #include "RootDirectoryContext.h"
+#include "LevelLoader.h"
 #include "windows/FontSettings.h"
 #include "windows/LevelPicker.h"
 #include "windows/LevelViewer.h"
@@ -10,6 +14,7 @@
 #include "windows/SdbViewer.h"
 #include "windows/MdfViewer.h"
 #include "windows/CsViewer.h"
+#include "windows/TelemetryViewer.h"
 
 struct SDL_Window;
 struct SDL_Renderer;
@@ -30,16 +35,31 @@ private:
     void initSdl();
     void initImGui(std::string_view fontFilepath, int fontSize);
 
-    bool processEvents(bool noWait);
+    bool processEvents(int waitTimeoutMs);
     void render();
 
     void shutdown();
 
+    bool isLevelOpened(std::string_view levelName, LevelType levelType) const;
+    void requestLevel(std::string_view levelName, LevelType levelType);
+    void loadNextQueuedLevel();
+
     bool hasActiveAnimations() const;
+    uint64_t nextAnimationFrameMs() const;
+    int eventWaitTimeoutMs() const;
 
     SDL_Window* m_window = nullptr;
     SDL_Renderer* m_renderer = nullptr;
     RootDirectoryContext m_rootDirContext;
+    std::unique_ptr<LevelLoader> m_levelLoader;
+
+    // Уровни, выбранные во время загрузки другого. Загружаются по очереди
+    struct LevelRequest {
+        std::string rootDirectory;
+        std::string levelName;
+        LevelType levelType;
+    };
+    std::deque<LevelRequest> m_levelQueue;
 
     std::optional<FontSettings> m_fontSettings;
     LevelPicker m_levelPicker;
@@ -48,6 +68,7 @@ private:
     SdbViewer m_sdbViewer;
     MdfViewer m_mdfViewer;
     CsViewer m_csViewer;
+    TelemetryViewer m_telemetryViewer;
 
     bool m_done = false;
 
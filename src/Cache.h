@@ -1,10 +1,12 @@
 #pragma once
 #include <string_view>
 #include <optional>
+#include <cstdint>
 #include <string>
+#include <ranges>
+#include <list>
 
 #include "utils/TracyProfiler.h"
-#include "utils/DebugLog.h"
 #include "Types.h"
 
 template<typename Callback, typename T>
@@ -12,37 +14,117 @@ concept LoadCallback = requires(Callback cb) {
     { cb() } -> std::same_as<std::optional<T>>;
 };
 
-template<class T, size_t MaxCached = 0>
+// Размер ресурса в байтах для бюджета кэша: byteSize(), сумма byteSize() элементов контейнера,
+// размер объекта по умному указателю, либо sizeof
+template<class T>
+struct CacheSizeOf {
+    size_t operator()(const T& value) const {
+        if constexpr (requires { { value.byteSize() } -> std::convertible_to<size_t>; }) {
+            return value.byteSize();
+        } else if constexpr (requires { typename T::element_type; value.get(); }) {
+            return value ? CacheSizeOf<std::remove_cv_t<typename T::element_type>>()(*value) : 0;
+        } else if constexpr (std::ranges::range<T>) {
+            size_t result = 0;
+            for (const auto& element : value) {
+                result += CacheSizeOf<std::ranges::range_value_t<T>>()(element);
+            }
+            return result;
+        } else {
+            return sizeof(T);
+        }
+    }
+};
+
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t residentBytes = 0;
+    size_t entryCount = 0;
+};
+
+// LRU-кэш с бюджетом в байтах (0 - без ограничения).
+// load() не вытесняет записи: указатели, полученные от load(), остаются действительными до trim() или clear().
+// trim() вызывается, когда указатели больше не используются (например, при смене выбранного файла)
+template<class T, class SizeOf = CacheSizeOf<T>>
 class Cache {
 public:
-    Cache() noexcept {}
+    explicit Cache(size_t byteBudget = 0, const char* plotName = nullptr) noexcept :
+        m_byteBudget(byteBudget),
+        m_plotName(plotName) {}
+
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
 
     template <LoadCallback<T> Callback>
     const T* load(std::string_view key, Callback&& callback) {
         Tracy_ZoneScoped;
         Tracy_ZoneText(key.data(), key.size());
-        if (auto it = m_cache.find(key); it != m_cache.end()) {
-            LogFmt("Load from cache: {}", key);
-            return &it->second;
+        if (auto it = m_index.find(key); it != m_index.end()) {
+            ++m_stats.hits;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return &it->second->value;
         }
 
+        ++m_stats.misses;
         std::optional<T> resource = std::forward<Callback>(callback)();
         if (!resource)
             return nullptr;
 
-        // Если есть лимит и он превышен, выгружаем ресурс
-        if constexpr (MaxCached > 0 && !m_cache.empty() && m_cache.size() >= MaxCached) {
-            m_cache.erase(m_cache.begin());
-        }
+        size_t byteSize = SizeOf()(*resource);
+        m_entries.push_front({std::string(key), std::move(*resource), byteSize});
+        m_index.emplace(m_entries.front().key, m_entries.begin());
 
-        auto [it, _] = m_cache.emplace(std::string(key), std::move(*resource));
-        return &it->second;
+        m_stats.residentBytes += byteSize;
+        m_stats.entryCount = m_entries.size();
+        plotStats();
+        return &m_entries.front().value;
+    }
+
+    // Вытесняет давно не использованные записи, пока объём превышает бюджет
+    void trim() noexcept {
+        if (m_byteBudget == 0)
+            return;
+
+        while (!m_entries.empty() && m_stats.residentBytes > m_byteBudget) {
+            const Entry& entry = m_entries.back();
+            m_stats.residentBytes -= entry.byteSize;
+            ++m_stats.evictions;
+            m_index.erase(entry.key);
+            m_entries.pop_back();
+        }
+        m_stats.entryCount = m_entries.size();
+        plotStats();
     }
 
     void clear() noexcept {
-        m_cache.clear();
+        m_stats.evictions += m_entries.size();
+        m_index.clear();
+        m_entries.clear();
+        m_stats.residentBytes = 0;
+        m_stats.entryCount = 0;
+        plotStats();
     }
 
+    const CacheStats& stats() const noexcept { return m_stats; }
+    size_t byteBudget() const noexcept { return m_byteBudget; }
+
 private:
-    StringHashTable<T> m_cache;
+    struct Entry {
+        std::string key;
+        T value;
+        size_t byteSize = 0;
+    };
+
+    void plotStats() const noexcept {
+        if (m_plotName) {
+            Tracy_Plot(m_plotName, (int64_t)m_stats.residentBytes);
+        }
+    }
+
+    std::list<Entry> m_entries; // Начало списка - последние использованные
+    StringHashTable<typename std::list<Entry>::iterator> m_index;
+    CacheStats m_stats;
+    size_t m_byteBudget = 0;
+    const char* m_plotName = nullptr;
 };
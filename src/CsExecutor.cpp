@@ -1,6 +1,7 @@
 #include "CsExecutor.h"
 
 #include <algorithm>
+#include <functional>
 #include <stdexcept>
 #include <cassert>
 #include <format>
@@ -15,10 +16,28 @@
 
 CsExecutor::CsExecutor(std::span<const CS_Node> nodes, const StringHashTable<AgeVariable_t>& globalVars) :
     m_nodes(nodes),
-    m_globalVars(globalVars)
+    m_program(nodes),
+    m_executedNodes(nodes.size()),
+    m_coveredStatements(m_program.statements.size())
 {
     assert(!m_nodes.empty());
-    assert(!m_globalVars.empty());
+    assert(!globalVars.empty());
+
+    // Глобальная таблица не копируется: берутся только значения переменных скрипта, по слотам
+    m_initialSlotValues.resize(m_program.slotNames.size());
+    for (size_t slot = 0; slot < m_program.slotNames.size(); ++slot) {
+        const std::string& name = m_program.slotNames[slot];
+        if (auto it = globalVars.find(name); it != globalVars.end()) {
+            m_initialSlotValues[slot] = it->second;
+        } else {
+            LogFmt("Script variable '{}' not found in globals vars", name);
+        }
+    }
+
+    m_slots.resize(m_program.slotNames.size());
+    for (size_t slot = 0; slot < m_program.slotNames.size(); ++slot) {
+        m_slots[slot] = &m_scriptVars[m_program.slotNames[slot]];
+    }
 
     readScriptVariables();
 }
@@ -56,12 +75,13 @@ bool parse3(std::string_view line,
 
 bool CsExecutor::readGlobalVariables(std::string_view varsPath, StringHashTable<AgeVariable_t>& globalVars, std::string* error)
 {
-    auto fileData = FileUtils::loadFile(varsPath, error);
-    if (fileData.empty()) {
+    MappedFile mappedFile = FileUtils::mapFile(varsPath, error);
+    if (!mappedFile) {
         return false;
     }
+    std::span<const uint8_t> fileData = mappedFile.data();
 
-    std::string_view fileStringView((char*)fileData.data(), fileData.size());
+    std::string_view fileStringView((const char*)fileData.data(), fileData.size());
     StringUtils::forEachLine(fileStringView, [&globalVars] (std::string_view line)
     {
         line = StringUtils::eraseOneLineComment(line);
@@ -93,15 +113,13 @@ bool CsExecutor::readGlobalVariables(std::string_view varsPath, StringHashTable<
 
 void CsExecutor::readScriptVariables()
 {
-    m_scriptVars.clear();
-    for (const auto& node : m_nodes) {
-        if (node.opcode == OpcodeType::kStringVarName) {
-            if (auto it = m_globalVars.find(node.text); it != m_globalVars.end()) {
-                m_scriptVars.emplace(node.text, it->second);
-            } else {
-                LogFmt("Script variable '{}' not found in globals vars", node.text);
-            }
-        }
+    // Ключи переменных скрипта не удаляются между перезапусками: m_slots указывают прямо на их значения
+    std::erase_if(m_scriptVars, [this] (const auto& item) {
+        return !m_program.slotIds.contains(item.first);
+    });
+
+    for (size_t slot = 0; slot < m_slots.size(); ++slot) {
+        *m_slots[slot] = m_initialSlotValues[slot];
     }
 }
 
@@ -152,7 +170,8 @@ std::vector<std::string> CsExecutor::funcsInfo() const {
     std::vector<std::string> out;
     out.reserve(m_funcs.size());
     char buffer[768];
-    for (const auto& func : m_funcs) {
+    for (int32_t funcIndex : m_funcs) {
+        const CS_Node& func = m_nodes[funcIndex];
         constexpr int kArgsInfoSize = 512;
         char argsInfo[kArgsInfoSize];
         argsInfo[0] = '\0';
@@ -193,10 +212,10 @@ std::array<int, 11> CsExecutor::dialogsData() const
     std::array<int, 11> result;
     result.fill(-1);
 
-    const CS_Node& sayNode = m_dialogFuncs.front();
+    const CS_Node& sayNode = m_nodes[m_dialogFuncs.front()];
     result[0] = m_nodes[sayNode.args.front()].value;
     for (size_t i = 1; i < m_dialogFuncs.size(); ++i) {
-        const CS_Node& answerNode = m_dialogFuncs[i];
+        const CS_Node& answerNode = m_nodes[m_dialogFuncs[i]];
         result[i] = m_nodes[answerNode.args.front()].value;
     }
     return result;
@@ -216,68 +235,53 @@ bool CsExecutor::next()
     }
     ++m_counter;
 
-    const CS_Node& currentNode = m_nodes[m_currentNodeIndex];
-    m_executedNodeIndexes.insert(m_currentNodeIndex);
-
-    OpcodeGroup group = csOpcodeToGroup(currentNode.opcode);
-    if (group == kLogical) {
-        bool isTrue = logicalOpcode(currentNode);
-        m_currentNodeIndex = isTrue ? currentNode.c : currentNode.d;
-    } else if (group == kComparison) {
-        bool isTrue = compareOpcode(currentNode);
-        m_currentNodeIndex = isTrue ? currentNode.c : currentNode.d;
-    } else {
+    if (m_currentNodeIndex < 0 || m_currentNodeIndex >= (int)m_program.statements.size()) {
+        fatalError( std::format("[currentNodeIndex: {}] out of range", m_currentNodeIndex) );
+    }
 
-        if (currentNode.opcode == kJmp) {
-            if (currentNode.d == -1) {
-                bool exists = std::any_of(m_dialogFuncs.cbegin(), m_dialogFuncs.cend(), [](const CS_Node& node) { return (uint32_t)node.value == kD_Say; });
-                m_currentStatus = exists ? kWaitUser : kEnd;
-                return false;
-            }
+    // Узлы, которые затрагивает инструкция, не зависят от значений: достаточно отметить их при первом выполнении
+    const CsProgram::Statement& statement = m_program.statements[m_currentNodeIndex];
+    if (m_coveredStatements.set(m_currentNodeIndex)) {
+        for (uint32_t i = statement.coverageBegin; i < statement.coverageEnd; ++i) {
+            m_executedNodes.set(m_program.coverage[i]);
+        }
+    }
 
-            m_currentNodeIndex = currentNode.c;
-        } else if (currentNode.opcode == kAssign) {
-            const CS_Node& rNode = m_nodes[currentNode.b];
-            AgeVariable_t rValue;
-            if (rNode.opcode == kStringVarName) {
-                rValue = m_scriptVars[rNode.text];
-            } else if (rNode.opcode == kNumberLiteral) {
-                rValue = (int)rNode.value; // TODO: Корректное приведение типов
-            } else if (rNode.opcode == kFunc) {
-                rValue = funcOpcode(rNode); // TODO: D_CloseDialog должен прерывать выполнение (m_currentStatus = kEnd;)
-            } else {
-                OpcodeGroup group = csOpcodeToGroup(rNode.opcode);
-                if (group == kArithmetic) {
-                    rValue = arithmeticOpcode(rNode);
-                } else {
-                    fatalError( std::format("[currentNode.opcode: assign] [rNode.opcode: {}]", csOpcodeToString(rNode.opcode)) );
-                }
-            }
+    switch (statement.op) {
+        case CsProgram::StatementOp::kBranch: {
+            bool isTrue = evaluateCondition(m_program.exprs[statement.rhs]);
+            m_currentNodeIndex = isTrue ? statement.onTrue : statement.onFalse;
+            break;
+        }
 
-            const CS_Node& lNode = m_nodes[currentNode.a];
-            if (lNode.opcode == kStringVarName) {
-                m_scriptVars[lNode.text] = rValue;
-            } else {
-                fatalError( std::format("[currentNode.opcode: assign] [lNode.opcode: {}]", csOpcodeToString(lNode.opcode)) );
-            }
+        case CsProgram::StatementOp::kJmp: {
+            m_currentNodeIndex = statement.onTrue;
+            break;
+        }
 
-            //LogFmt("[currentNode.opcode: assign] lNode.opcode: {}, rNode.opcode: {}", csOpcodeToString(lNode.opcode), csOpcodeToString(rNode.opcode));
-            m_executedNodeIndexes.insert(currentNode.a);
-            m_executedNodeIndexes.insert(currentNode.b);
-            m_currentNodeIndex = currentNode.d;
-        } else {
-            std::string errorMessage;
-            if (currentNode.a == -1 || currentNode.b == -1) {
-                errorMessage = std::format("[currentNode.opcode: {}]", csOpcodeToString(currentNode.opcode));
-            } else {
-                const CS_Node& lNode = m_nodes[currentNode.a];
-                const CS_Node& rNode = m_nodes[currentNode.b];
-                errorMessage = std::format("[currentNode.opcode: {}] lNode.opcode: {}, rNode.opcode: {}",
-                                           csOpcodeToString(currentNode.opcode), csOpcodeToString(lNode.opcode), csOpcodeToString(rNode.opcode));
+        case CsProgram::StatementOp::kStop: {
+            bool exists = std::any_of(m_dialogFuncs.cbegin(), m_dialogFuncs.cend(), [this] (int32_t funcIndex) {
+                return (uint32_t)m_nodes[funcIndex].value == kD_Say;
+            });
+            m_currentStatus = exists ? kWaitUser : kEnd;
+            return false;
+        }
+
+        case CsProgram::StatementOp::kAssign: {
+            AgeVariable_t rValue = evaluateValue(m_program.exprs[statement.rhs], nullptr); // TODO: D_CloseDialog должен прерывать выполнение (m_currentStatus = kEnd;)
+            const CsProgram::Expr& lExpr = m_program.exprs[statement.lhs];
+            if (lExpr.op != CsProgram::ExprOp::kVariable) {
+                invalidExprError(lExpr);
             }
-            fatalError(errorMessage);
+            *m_slots[lExpr.slot] = std::move(rValue);
+            m_currentNodeIndex = statement.onTrue;
+            break;
         }
 
+        case CsProgram::StatementOp::kInvalid: {
+            invalidStatementError();
+            break;
+        }
     }
 
     m_currentStatus = kContinue;
@@ -286,7 +290,7 @@ bool CsExecutor::next()
 
 void CsExecutor::userInput(uint8_t answer) {
     assert(!m_dialogFuncs.empty());
-    CS_Node sayNode = m_dialogFuncs[0];
+    const CS_Node& sayNode = m_nodes[m_dialogFuncs[0]];
     assert((uint32_t)sayNode.value == kD_Say);
 
     // Мы застряли на вводе, т.к. ответить юзеру нечем
@@ -297,7 +301,7 @@ void CsExecutor::userInput(uint8_t answer) {
         return;
     }
 
-    CS_Node answerNode = m_dialogFuncs[answer];
+    const CS_Node& answerNode = m_nodes[m_dialogFuncs[answer]];
     assert((uint32_t)answerNode.value == kD_Answer);
 
     m_scriptVars["LastPhrase"] = (uint32_t)m_nodes[sayNode.args.front()].value;
@@ -309,142 +313,159 @@ void CsExecutor::userInput(uint8_t answer) {
     m_currentNodeIndex = 0;
 }
 
-bool CsExecutor::logicalOpcode(const CS_Node& node) {
-    const CS_Node& lNode = m_nodes[node.a];
-    const CS_Node& rNode = m_nodes[node.b];
-    int isLeftValue = 0;
-    int isRightValue = 0;
-    if (csOpcodeToGroup(lNode.opcode) == kComparison) {
-        isLeftValue = compareOpcode(lNode);
-    } else if (csOpcodeToGroup(lNode.opcode) == kLogical) {
-        isLeftValue = logicalOpcode(lNode);
-    } else if (lNode.opcode == kFunc) {
-        isLeftValue = funcOpcode(lNode);
-    } else {
-        fatalError( std::format("logicalOpcode [lNode.opcode: {}]", csOpcodeToString(lNode.opcode)) );
+CsExecutor::State CsExecutor::saveState() const
+{
+    State state;
+    state.slotValues.reserve(m_slots.size());
+    for (const AgeVariable_t* value : m_slots) {
+        state.slotValues.push_back(*value);
+    }
+    for (const auto& [name, value] : m_scriptVars) {
+        if (!m_program.slotIds.contains(name)) {
+            state.extraVars.emplace_back(name, value);
+        }
     }
+    state.funcs = m_funcs;
+    state.dialogFuncs = m_dialogFuncs;
+    state.currentNodeIndex = m_currentNodeIndex;
+    state.currentStatus = m_currentStatus;
+    state.counter = m_counter;
+    return state;
+}
 
-    if (csOpcodeToGroup(rNode.opcode) == kComparison) {
-        isRightValue = compareOpcode(rNode);
-    } else if (csOpcodeToGroup(rNode.opcode) == kLogical) {
-        isRightValue = logicalOpcode(rNode);
-    } else if (rNode.opcode == kFunc) {
-        isRightValue = funcOpcode(rNode);
-    } else {
-        fatalError( std::format("logicalOpcode [rNode.opcode: {}]", csOpcodeToString(rNode.opcode)) );
+void CsExecutor::restoreState(const State& state)
+{
+    assert(state.slotValues.size() == m_slots.size());
+    for (size_t slot = 0; slot < m_slots.size(); ++slot) {
+        *m_slots[slot] = state.slotValues[slot];
     }
 
-    bool isTrue = false;
-    if (node.opcode == kLogicOr) {
-        isTrue = isLeftValue || isRightValue;
-    } else if (node.opcode == kLogicAnd) {
-        isTrue = isLeftValue && isRightValue;
-    } else {
-        fatalError( std::format("logicalOpcode [node.opcode: {}]", csOpcodeToString(node.opcode)) );
+    // Удаление других ключей не затрагивает значения, на которые указывают m_slots
+    std::erase_if(m_scriptVars, [this] (const auto& item) {
+        return !m_program.slotIds.contains(item.first);
+    });
+    for (const auto& [name, value] : state.extraVars) {
+        m_scriptVars.emplace(name, value);
     }
-    // LogFmt("[currentNode.opcode: {}] lNode.opcode: {}, rNode.opcode: {}", csOpcodeToString(node.opcode), csOpcodeToString(lNode.opcode), csOpcodeToString(rNode.opcode));
-    // LogFmt("isLeftValue: {}, isRightValue: {}, isTrue: {}", isLeftValue, isRightValue, isTrue);
-    m_executedNodeIndexes.insert(node.a);
-    m_executedNodeIndexes.insert(node.b);
-    return isTrue;
-}
-
-bool CsExecutor::compareOpcode(const CS_Node& node) {
-    const CS_Node& lNode = m_nodes[node.a];
-    AgeVariable_t lValue;
-    if (lNode.opcode == kStringVarName) {
-        lValue = m_scriptVars[lNode.text];
-    } else if (lNode.opcode == kNumberLiteral) {
-        lValue = lNode.value;
-    } else if (lNode.opcode == kNumberVarName) {
-        lValue = lNode.value; // Корректно?
-    } else if (lNode.opcode == kFunc) {
-        lValue = funcOpcode(lNode);
-    } else {
-        fatalError( std::format("compareOpcode [lNode.opcode: {}]", csOpcodeToString(lNode.opcode)) );
+
+    m_funcs = state.funcs;
+    m_dialogFuncs = state.dialogFuncs;
+    m_currentNodeIndex = state.currentNodeIndex;
+    m_currentStatus = state.currentStatus;
+    m_counter = state.counter;
+}
+
+CsExecutor::StateKey CsExecutor::stateKey() const
+{
+    StateKey key;
+    key.slotValues.reserve(m_slots.size());
+    for (const AgeVariable_t* value : m_slots) {
+        key.slotValues.push_back(*value);
     }
+    key.dialogFuncs = m_dialogFuncs;
+    key.currentNodeIndex = m_currentNodeIndex;
+    key.currentStatus = m_currentStatus;
+    return key;
+}
 
-    const CS_Node& rNode = m_nodes[node.b];
-    AgeVariable_t rValue;
-    if (rNode.opcode == kStringVarName) {
-        rValue = m_scriptVars[rNode.text];
-    } else if (rNode.opcode == kNumberLiteral) {
-        // NOTE: Приведение типа равного lValue
-        std::visit([&rValue, rNode](auto&& lv){
-            using T = std::decay_t<decltype(lv)>;
-            if constexpr (std::is_same_v<T, std::string>) {
-                LogFmt("rValue string: {}", rNode.text);
-                rValue = rNode.value;
-            } else {
-                rValue = (T)rNode.value;
+uint64_t CsExecutor::StateKey::hash() const
+{
+    uint64_t hash = 0;
+    auto combine = [&hash] (uint64_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    };
+
+    combine(static_cast<uint64_t>(currentNodeIndex));
+    combine(static_cast<uint64_t>(currentStatus));
+    for (const AgeVariable_t& value : slotValues) {
+        combine(std::hash<AgeVariable_t>{}(value));
+    }
+    for (int32_t funcIndex : dialogFuncs) {
+        combine(static_cast<uint64_t>(funcIndex));
+    }
+    return hash;
+}
+
+bool CsExecutor::evaluateCondition(const CsProgram::Expr& expr)
+{
+    switch (expr.op) {
+        case CsProgram::ExprOp::kComparison:
+            return compareOpcode(expr);
+
+        case CsProgram::ExprOp::kFunc:
+            return funcOpcode(expr.node) != 0;
+
+        case CsProgram::ExprOp::kLogical: {
+            // Вычисляются обе части: вызовы функций попадают в m_funcs независимо от результата
+            bool isLeftValue = evaluateCondition(m_program.exprs[expr.lhs]);
+            bool isRightValue = evaluateCondition(m_program.exprs[expr.rhs]);
+            if (expr.opcode == kLogicOr) {
+                return isLeftValue || isRightValue;
+            } else if (expr.opcode == kLogicAnd) {
+                return isLeftValue && isRightValue;
             }
-        }, lValue);
-    } else {
-        OpcodeGroup group = csOpcodeToGroup(rNode.opcode);
-        if (group == kArithmetic) {
-            rValue = arithmeticOpcode(rNode);
-        } else {
-            fatalError( std::format("compareOpcode [rNode.opcode: {}]", csOpcodeToString(rNode.opcode)) );
+            fatalError( std::format("logicalOpcode [node.opcode: {}]", csOpcodeToString(expr.opcode)) );
+            break;
         }
-    }
 
-    bool isTrue = false;
-    if (node.opcode == 6) {
-        isTrue = (lValue != rValue);
-    } else if (node.opcode == 7) {
-        isTrue = (lValue == rValue);
-    } else if (node.opcode == 8) {
-        isTrue = (lValue >= rValue);
-    } else if (node.opcode == 9) {
-        isTrue = (lValue <= rValue);
-    } else if (node.opcode == 10) {
-        isTrue = (lValue > rValue);
-    } else if (node.opcode == 11) {
-        isTrue = (lValue < rValue);
+        default:
+            invalidExprError(expr);
     }
-    // LogFmt("[currentNode.opcode: {}] lNode.opcode: {}, rNode.opcode: {}", csOpcodeToString(node.opcode), csOpcodeToString(lNode.opcode), csOpcodeToString(rNode.opcode));
-    // LogFmt("lValue: {}, rValue: {}, isTrue: {}", lValue, rValue, isTrue);
-    m_executedNodeIndexes.insert(node.a);
-    m_executedNodeIndexes.insert(node.b);
-    return isTrue;
+    return false;
 }
 
-AgeVariable_t CsExecutor::arithmeticOpcode(const CS_Node& node)
-{
-    const CS_Node& lNode = m_nodes[node.a];
-    AgeVariable_t lValue;
-    if (lNode.opcode == kStringVarName) {
-        lValue = m_scriptVars[lNode.text];
-    } else if (lNode.opcode == kNumberLiteral) {
-        lValue = lNode.value;
-    } else if (lNode.opcode == kNumberVarName) {
-        lValue = lNode.value; // Корректно?
-    } else {
-        fatalError( std::format("arithmeticOpcode [lNode.opcode: {}]", csOpcodeToString(lNode.opcode)) );
+bool CsExecutor::compareOpcode(const CsProgram::Expr& expr) {
+    AgeVariable_t lValue = evaluateValue(m_program.exprs[expr.lhs], nullptr);
+    AgeVariable_t rValue = evaluateValue(m_program.exprs[expr.rhs], &lValue);
+
+    switch (expr.opcode) {
+        case 6: return (lValue != rValue);
+        case 7: return (lValue == rValue);
+        case 8: return (lValue >= rValue);
+        case 9: return (lValue <= rValue);
+        case 10: return (lValue > rValue);
+        case 11: return (lValue < rValue);
     }
+    return false;
+}
 
-    const CS_Node& rNode = m_nodes[node.b];
-    AgeVariable_t rValue;
-    if (rNode.opcode == kStringVarName) {
-        rValue = m_scriptVars[rNode.text];
-    } else if (rNode.opcode == kNumberLiteral) {
-        // NOTE: Приведение типа равного lValue
-        std::visit([&rValue, rNode](auto&& lv){
-            using T = std::decay_t<decltype(lv)>;
-            if constexpr (std::is_same_v<T, std::string>) {
-                LogFmt("rValue string: {}", rNode.text);
-                rValue = rNode.value;
-            } else {
-                rValue = (T)rNode.value;
+AgeVariable_t CsExecutor::evaluateValue(const CsProgram::Expr& expr, const AgeVariable_t* lhsValue)
+{
+    switch (expr.op) {
+        case CsProgram::ExprOp::kVariable:
+            return *m_slots[expr.slot];
+
+        case CsProgram::ExprOp::kNumber:
+            return expr.number;
+
+        case CsProgram::ExprOp::kInteger:
+            return expr.integer;
+
+        case CsProgram::ExprOp::kNumberLike: {
+            // NOTE: Приведение типа равного lValue
+            assert(lhsValue);
+            switch (lhsValue->index()) {
+                case 0: return (int32_t)expr.number;
+                case 1: return (uint32_t)expr.number;
+                case 2: return expr.number;
             }
-        }, lValue);
-    } else {
-        fatalError( std::format("arithmeticOpcode [rNode.opcode: {}]", csOpcodeToString(rNode.opcode)) );
-    }
+            LogFmt("rValue string: {}", m_nodes[expr.node].text);
+            return expr.number;
+        }
 
-    m_executedNodeIndexes.insert(node.a);
-    m_executedNodeIndexes.insert(node.b);
-    return applyBinaryOp(lValue, rValue, node.opcode);
+        case CsProgram::ExprOp::kFunc:
+            return funcOpcode(expr.node);
+
+        case CsProgram::ExprOp::kArithmetic: {
+            AgeVariable_t lValue = evaluateValue(m_program.exprs[expr.lhs], nullptr);
+            AgeVariable_t rValue = evaluateValue(m_program.exprs[expr.rhs], &lValue);
+            return applyBinaryOp(lValue, rValue, expr.opcode);
+        }
+
+        default:
+            invalidExprError(expr);
+    }
+    return 0;
 }
 
 AgeVariable_t CsExecutor::applyBinaryOp(const AgeVariable_t& lhs, const AgeVariable_t& rhs, int opcode) {
@@ -476,17 +497,13 @@ AgeVariable_t CsExecutor::applyBinaryOp(const AgeVariable_t& lhs, const AgeVaria
     lhs, rhs);
 }
 
-int CsExecutor::funcOpcode(const CS_Node& node)
+int CsExecutor::funcOpcode(int32_t nodeIndex)
 {
-    m_funcs.emplace_back(node);
+    const CS_Node& node = m_nodes[nodeIndex];
+    m_funcs.push_back(nodeIndex);
     uint32_t funcValue = static_cast<uint32_t>(node.value);
     if (funcValue == kD_Say || funcValue == kD_Answer) {
-        m_dialogFuncs.emplace_back(node);
-    }
-
-    for (auto arg : node.args) {
-        if (arg == -1) break;
-        m_executedNodeIndexes.insert(arg);
+        m_dialogFuncs.push_back(nodeIndex);
     }
 
     switch (funcValue) {
@@ -510,6 +527,26 @@ void CsExecutor::fatalError(const std::string& message) const
     throw std::runtime_error{message};
 }
 
+void CsExecutor::invalidStatementError() const
+{
+    const CS_Node& currentNode = m_nodes[m_currentNodeIndex];
+    std::string errorMessage;
+    if (currentNode.a == -1 || currentNode.b == -1) {
+        errorMessage = std::format("[currentNode.opcode: {}]", csOpcodeToString(currentNode.opcode));
+    } else {
+        const CS_Node& lNode = m_nodes[currentNode.a];
+        const CS_Node& rNode = m_nodes[currentNode.b];
+        errorMessage = std::format("[currentNode.opcode: {}] lNode.opcode: {}, rNode.opcode: {}",
+                                   csOpcodeToString(currentNode.opcode), csOpcodeToString(lNode.opcode), csOpcodeToString(rNode.opcode));
+    }
+    fatalError(errorMessage);
+}
+
+void CsExecutor::invalidExprError(const CsProgram::Expr& expr) const
+{
+    fatalError( std::format("{} [{}.opcode: {}]", expr.where, expr.side, csOpcodeToString(expr.opcode)) );
+}
+
 int CsExecutor::RS_GetPersonParameterI(std::string_view person, std::string_view param) {
     if (person == "Hero") {
         auto it = m_heroStats.find(param);
@@ -542,11 +579,19 @@ const char* CsExecutor::currentStatusString() const
 }
 
 bool CsExecutor::isNodeExecuted(int index) const {
-    return m_executedNodeIndexes.contains(index);
+    return index >= 0 && index < (int)m_executedNodes.size() && m_executedNodes.test(index);
 }
 
 float CsExecutor::executedPercent() const {
-    return ((float)m_executedNodeIndexes.size() / (float)m_nodes.size()) * 100.0f;
+    return ((float)m_executedNodes.count() / (float)m_nodes.size()) * 100.0f;
+}
+
+const DynamicBitset& CsExecutor::coverage() const {
+    return m_executedNodes;
+}
+
+void CsExecutor::mergeCoverage(const DynamicBitset& coverage) {
+    m_executedNodes.merge(coverage);
 }
 
 StringHashTable<AgeVariable_t>& CsExecutor::scriptVars() {
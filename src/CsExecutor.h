@@ -1,10 +1,13 @@
 #pragma once
 #include <string_view>
+#include <cstdint>
+#include <utility>
 #include <vector>
 #include <span>
-#include <set>
 
 #include "parsers/CS_Parser.h"
+#include "utils/DynamicBitset.h"
+#include "CsProgram.h"
 #include "Types.h"
 
 enum VarType {
@@ -16,7 +19,10 @@ enum VarType {
 
 class CsExecutor {
 public:
+    // Из globalVars берутся только переменные скрипта, ссылка не сохраняется
     CsExecutor(std::span<const CS_Node> nodes, const StringHashTable<AgeVariable_t>& globalVars);
+    CsExecutor(const CsExecutor&) = delete; // m_slots указывают на собственные значения m_scriptVars
+    CsExecutor& operator=(const CsExecutor&) = delete;
 
     static bool readGlobalVariables(std::string_view varsPath, StringHashTable<AgeVariable_t>& globalVars, std::string* error);
 
@@ -33,6 +39,33 @@ public:
     bool next();
     void userInput(uint8_t value);
 
+    // Снимок выполнения, чтобы вернуться к развилке диалога без повторного прохода от restart.
+    // Покрытие в снимок не входит: оно только накапливается
+    struct State {
+        std::vector<AgeVariable_t> slotValues;
+        std::vector<std::pair<std::string, AgeVariable_t>> extraVars; // Не используемые скриптом (LastPhrase, LastAnswer)
+        std::vector<int32_t> funcs;
+        std::vector<int32_t> dialogFuncs;
+        int currentNodeIndex = 0;
+        ExecuteStatus currentStatus = kStart;
+        int counter = 0;
+    };
+    State saveState() const;
+    void restoreState(const State& state);
+
+    // Всё, от чего зависит дальнейшее выполнение: узел, статус, переменные скрипта и варианты ответа.
+    // Счётчик защиты от бесконечного выполнения не учитывается
+    struct StateKey {
+        std::vector<AgeVariable_t> slotValues;
+        std::vector<int32_t> dialogFuncs;
+        int currentNodeIndex = 0;
+        ExecuteStatus currentStatus = kStart;
+
+        bool operator==(const StateKey&) const = default;
+        uint64_t hash() const;
+    };
+    StateKey stateKey() const;
+
     int currentNodeIndex() const;
     int counter() const;
     std::vector<std::string> variablesInfo() const;
@@ -46,29 +79,37 @@ public:
 
     bool isNodeExecuted(int index) const;
     float executedPercent() const;
+    // Покрытие узлов: бит на узел. Покрытие нескольких запусков одного скрипта объединяется через mergeCoverage
+    const DynamicBitset& coverage() const;
+    void mergeCoverage(const DynamicBitset& coverage);
 
 private:
     void readScriptVariables();
 
-    bool logicalOpcode(const CS_Node& node);
-    bool compareOpcode(const CS_Node& node);
-    AgeVariable_t arithmeticOpcode(const CS_Node& node);
+    bool evaluateCondition(const CsProgram::Expr& expr);
+    bool compareOpcode(const CsProgram::Expr& expr);
+    AgeVariable_t evaluateValue(const CsProgram::Expr& expr, const AgeVariable_t* lhsValue);
     AgeVariable_t applyBinaryOp(const AgeVariable_t& lhs, const AgeVariable_t& rhs, int opcode);
-    int funcOpcode(const CS_Node& node);
+    int funcOpcode(int32_t nodeIndex);
 
     void fatalError(const std::string& message) const;
+    void invalidStatementError() const;
+    void invalidExprError(const CsProgram::Expr& expr) const;
 
     int RS_GetPersonParameterI(std::string_view person, std::string_view param);
     int D_CloseDialog(int param);
 
     std::span<const CS_Node> m_nodes;
-    StringHashTable<AgeVariable_t> m_globalVars;
+    CsProgram m_program;
     StringHashTable<AgeVariable_t> m_scriptVars;
-    std::vector<CS_Node> m_funcs;
-    std::vector<CS_Node> m_dialogFuncs;
+    std::vector<AgeVariable_t> m_initialSlotValues; // Значения из глобальной таблицы по слотам m_program
+    std::vector<AgeVariable_t*> m_slots; // Значения m_scriptVars по слотам m_program
+    std::vector<int32_t> m_funcs;        // Индексы узлов вызванных функций
+    std::vector<int32_t> m_dialogFuncs;
 
     StringHashTable<int> m_heroStats; // TODO: Нужна реализация
-    std::set<int> m_executedNodeIndexes;
+    DynamicBitset m_executedNodes;
+    DynamicBitset m_coveredStatements; // Инструкции, узлы которых уже отмечены в m_executedNodes
 
     int m_currentNodeIndex = 0;
     ExecuteStatus m_currentStatus = kStart;
@@ -0,0 +1,184 @@
+#include "CsProgram.h"
+
+#include "enums/CsOpcodes.h"
+
+CsProgram::CsProgram(std::span<const CS_Node> nodes) :
+    m_nodes(nodes)
+{
+    // Слоты для всех переменных скрипта, в том числе недостижимых: CsExecutor показывает их все
+    for (const CS_Node& node : m_nodes) {
+        if (node.opcode == kStringVarName && !slotIds.contains(node.text)) {
+            slotIds.emplace(node.text, static_cast<int32_t>(slotNames.size()));
+            slotNames.push_back(node.text);
+        }
+    }
+
+    statements.resize(m_nodes.size());
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        const int32_t nodeIndex = static_cast<int32_t>(i);
+        const CS_Node& node = m_nodes[i];
+        Statement& statement = statements[i];
+        statement.coverageBegin = static_cast<uint32_t>(coverage.size());
+        addCoverage(nodeIndex);
+
+        const OpcodeGroup group = csOpcodeToGroup(node.opcode);
+        if (group == kLogical) {
+            statement.op = StatementOp::kBranch;
+            statement.rhs = compileCondition(nodeIndex, "logicalOpcode", "node", 0);
+            statement.onTrue = node.c;
+            statement.onFalse = node.d;
+        } else if (group == kComparison) {
+            statement.op = StatementOp::kBranch;
+            statement.rhs = compileComparison(nodeIndex, 0);
+            statement.onTrue = node.c;
+            statement.onFalse = node.d;
+        } else if (node.opcode == kJmp) {
+            statement.op = (node.d == -1) ? StatementOp::kStop : StatementOp::kJmp;
+            statement.onTrue = node.c;
+        } else if (node.opcode == kAssign) {
+            // Порядок как при выполнении: сначала правая часть
+            statement.op = StatementOp::kAssign;
+            statement.rhs = compileOperand(node.b, kAllowVariable | kAllowNumber | kNumberAsInteger | kAllowFunc | kAllowArithmetic,
+                                           "[currentNode.opcode: assign]", "rNode", 0);
+            statement.lhs = compileOperand(node.a, kAllowVariable, "[currentNode.opcode: assign]", "lNode", 0);
+            addCoverage(node.a);
+            addCoverage(node.b);
+            statement.onTrue = node.d;
+        }
+        statement.coverageEnd = static_cast<uint32_t>(coverage.size());
+    }
+
+    m_nodes = {};
+}
+
+int32_t CsProgram::compileCondition(int32_t nodeIndex, const char* where, const char* side, int depth)
+{
+    if (!isValidIndex(nodeIndex) || depth > kMaxDepth) {
+        return addInvalid(nodeIndex, where, side);
+    }
+
+    const CS_Node& node = m_nodes[nodeIndex];
+    const OpcodeGroup group = csOpcodeToGroup(node.opcode);
+    if (group == kComparison) {
+        return compileComparison(nodeIndex, depth + 1);
+    } else if (group == kLogical) {
+        Expr expr;
+        expr.op = ExprOp::kLogical;
+        expr.opcode = node.opcode;
+        expr.node = nodeIndex;
+        expr.lhs = compileCondition(node.a, "logicalOpcode", "lNode", depth + 1);
+        expr.rhs = compileCondition(node.b, "logicalOpcode", "rNode", depth + 1);
+        addCoverage(node.a);
+        addCoverage(node.b);
+        return addExpr(expr);
+    } else if (node.opcode == kFunc) {
+        return compileFunc(nodeIndex);
+    }
+    return addInvalid(nodeIndex, where, side);
+}
+
+int32_t CsProgram::compileComparison(int32_t nodeIndex, int depth)
+{
+    const CS_Node& node = m_nodes[nodeIndex];
+    Expr expr;
+    expr.op = ExprOp::kComparison;
+    expr.opcode = node.opcode;
+    expr.node = nodeIndex;
+    expr.lhs = compileOperand(node.a, kAllowVariable | kAllowNumber | kAllowNumberVar | kAllowFunc, "compareOpcode", "lNode", depth + 1);
+    expr.rhs = compileOperand(node.b, kAllowVariable | kAllowNumber | kNumberLikeLhs | kAllowArithmetic, "compareOpcode", "rNode", depth + 1);
+    addCoverage(node.a);
+    addCoverage(node.b);
+    return addExpr(expr);
+}
+
+int32_t CsProgram::compileArithmetic(int32_t nodeIndex, int depth)
+{
+    const CS_Node& node = m_nodes[nodeIndex];
+    Expr expr;
+    expr.op = ExprOp::kArithmetic;
+    expr.opcode = node.opcode;
+    expr.node = nodeIndex;
+    expr.lhs = compileOperand(node.a, kAllowVariable | kAllowNumber | kAllowNumberVar, "arithmeticOpcode", "lNode", depth + 1);
+    expr.rhs = compileOperand(node.b, kAllowVariable | kAllowNumber | kNumberLikeLhs, "arithmeticOpcode", "rNode", depth + 1);
+    addCoverage(node.a);
+    addCoverage(node.b);
+    return addExpr(expr);
+}
+
+int32_t CsProgram::compileOperand(int32_t nodeIndex, uint32_t flags, const char* where, const char* side, int depth)
+{
+    if (!isValidIndex(nodeIndex) || depth > kMaxDepth) {
+        return addInvalid(nodeIndex, where, side);
+    }
+
+    const CS_Node& node = m_nodes[nodeIndex];
+    Expr expr;
+    expr.opcode = node.opcode;
+    expr.node = nodeIndex;
+    if (node.opcode == kStringVarName && (flags & kAllowVariable)) {
+        expr.op = ExprOp::kVariable;
+        expr.slot = slotIds.find(node.text)->second;
+    } else if (node.opcode == kNumberLiteral && (flags & kAllowNumber)) {
+        if (flags & kNumberAsInteger) {
+            expr.op = ExprOp::kInteger;
+            expr.integer = (int)node.value; // TODO: Корректное приведение типов
+        } else {
+            expr.op = (flags & kNumberLikeLhs) ? ExprOp::kNumberLike : ExprOp::kNumber;
+            expr.number = node.value;
+        }
+    } else if (node.opcode == kNumberVarName && (flags & kAllowNumberVar)) {
+        expr.op = ExprOp::kNumber; // Корректно?
+        expr.number = node.value;
+    } else if (node.opcode == kFunc && (flags & kAllowFunc)) {
+        return compileFunc(nodeIndex);
+    } else if (csOpcodeToGroup(node.opcode) == kArithmetic && (flags & kAllowArithmetic)) {
+        return compileArithmetic(nodeIndex, depth);
+    } else {
+        return addInvalid(nodeIndex, where, side);
+    }
+    return addExpr(expr);
+}
+
+int32_t CsProgram::compileFunc(int32_t nodeIndex)
+{
+    const CS_Node& node = m_nodes[nodeIndex];
+    for (int32_t arg : node.args) {
+        if (arg == -1) break;
+        addCoverage(arg);
+    }
+
+    Expr expr;
+    expr.op = ExprOp::kFunc;
+    expr.opcode = node.opcode;
+    expr.node = nodeIndex;
+    return addExpr(expr);
+}
+
+int32_t CsProgram::addInvalid(int32_t nodeIndex, const char* where, const char* side)
+{
+    Expr expr;
+    expr.op = ExprOp::kInvalid;
+    expr.opcode = isValidIndex(nodeIndex) ? m_nodes[nodeIndex].opcode : -1;
+    expr.node = nodeIndex;
+    expr.where = where;
+    expr.side = side;
+    return addExpr(expr);
+}
+
+int32_t CsProgram::addExpr(const Expr& expr)
+{
+    exprs.push_back(expr);
+    return static_cast<int32_t>(exprs.size() - 1);
+}
+
+void CsProgram::addCoverage(int32_t nodeIndex)
+{
+    if (isValidIndex(nodeIndex)) {
+        coverage.push_back(nodeIndex);
+    }
+}
+
+bool CsProgram::isValidIndex(int32_t nodeIndex) const
+{
+    return nodeIndex >= 0 && nodeIndex < static_cast<int32_t>(m_nodes.size());
+}
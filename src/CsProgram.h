@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <span>
+
+#include "parsers/CS_Parser.h"
+#include "Types.h"
+
+// Скомпилированная форма узлов CS для CsExecutor. Узлы разбираются один раз:
+// имена переменных заменяются слотами, числовые литералы приводятся к нужному типу заранее,
+// для каждой инструкции заранее известен список узлов, которые она затрагивает (покрытие).
+// Индексы инструкций совпадают с индексами узлов, поэтому переходы c/d используются как есть.
+// Неподдерживаемые сочетания узлов не бросают исключение при компиляции, а становятся kInvalid:
+// ошибка возникает только при выполнении, как и в исходном интерпретаторе
+class CsProgram {
+public:
+    enum class StatementOp : uint8_t {
+        kInvalid,
+        kBranch, // Логический узел или сравнение: переход на onTrue/onFalse
+        kJmp,
+        kStop,   // jmp с d == -1: конец выполнения
+        kAssign
+    };
+
+    enum class ExprOp : uint8_t {
+        kInvalid,
+        kVariable,
+        kNumber,     // double
+        kInteger,    // int32_t (правая часть присваивания)
+        kNumberLike, // Приводится к типу левого операнда при выполнении
+        kFunc,
+        kLogical,
+        kComparison,
+        kArithmetic
+    };
+
+    struct Expr {
+        ExprOp op = ExprOp::kInvalid;
+        int32_t opcode = -1;
+        int32_t node = -1;  // Индекс узла CS
+        int32_t lhs = -1;   // Индексы в exprs
+        int32_t rhs = -1;
+        int32_t slot = -1;  // kVariable
+        int32_t integer = 0;
+        double number = 0.0;
+        const char* where = nullptr; // kInvalid: контекст для сообщения об ошибке
+        const char* side = nullptr;
+    };
+
+    struct Statement {
+        StatementOp op = StatementOp::kInvalid;
+        int32_t lhs = -1; // kAssign: переменная
+        int32_t rhs = -1; // kBranch: условие, kAssign: значение
+        int32_t onTrue = -1;
+        int32_t onFalse = -1;
+        uint32_t coverageBegin = 0; // Диапазон в coverage
+        uint32_t coverageEnd = 0;
+    };
+
+    CsProgram() = default;
+    explicit CsProgram(std::span<const CS_Node> nodes);
+
+    std::vector<Statement> statements;
+    std::vector<Expr> exprs;
+    std::vector<int32_t> coverage;
+    std::vector<std::string> slotNames;
+    StringHashTable<int32_t> slotIds;
+
+private:
+    enum OperandFlags : uint32_t {
+        kAllowVariable   = 1 << 0,
+        kAllowNumber     = 1 << 1,
+        kAllowNumberVar  = 1 << 2,
+        kAllowFunc       = 1 << 3,
+        kAllowArithmetic = 1 << 4,
+        kNumberLikeLhs   = 1 << 5, // Литерал приводится к типу левого операнда
+        kNumberAsInteger = 1 << 6
+    };
+
+    static constexpr int kMaxDepth = 256;
+
+    int32_t compileCondition(int32_t nodeIndex, const char* where, const char* side, int depth);
+    int32_t compileComparison(int32_t nodeIndex, int depth);
+    int32_t compileArithmetic(int32_t nodeIndex, int depth);
+    int32_t compileOperand(int32_t nodeIndex, uint32_t flags, const char* where, const char* side, int depth);
+    int32_t compileFunc(int32_t nodeIndex);
+    int32_t addInvalid(int32_t nodeIndex, const char* where, const char* side);
+    int32_t addExpr(const Expr& expr);
+    void addCoverage(int32_t nodeIndex);
+
+    bool isValidIndex(int32_t nodeIndex) const;
+
+    std::span<const CS_Node> m_nodes;
+};
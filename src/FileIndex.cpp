@@ -0,0 +1,433 @@
+#include "FileIndex.h"
+
+#include <condition_variable>
+#include <filesystem>
+#include <algorithm>
+#include <format>
+#include <atomic>
+#include <future>
+#include <deque>
+#include <mutex>
+
+#include "graphics/AssetCache.h"
+#include "utils/TracyProfiler.h"
+#include "utils/StringUtils.h"
+#include "utils/ThreadPool.h"
+#include "utils/FileUtils.h"
+#include "utils/DebugLog.h"
+#include "utils/IoUtils.h"
+#include "Types.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint32_t kMagic = 0x49464C47; // "GLFI"
+constexpr uint32_t kVersion = 1;
+
+enum FileKind : uint8_t {
+    kCsx = 1 << 0,
+    kSdb = 1 << 1,
+    kMdf = 1 << 2,
+    kCs  = 1 << 3
+};
+
+// Каталоги, в которых ищутся файлы каждого типа (вложенные каталоги тоже)
+struct Scope {
+    std::string_view directory;
+    FileKind kind;
+};
+
+constexpr Scope kScopes[] = {
+    {"engineres",          kCsx},
+    {"levels/pack",        kCsx},
+    {"magic/bitmap",       kCsx},
+    {"persons",            kCsx},
+    {"wear",               kCsx},
+    {"levels/single",      kSdb},
+    {"levels/multiplayer", kSdb},
+    {"sdb",                kSdb},
+    {"magic",              kMdf},
+    {"scripts/dialogs",    kCs}
+};
+
+struct FileRecord {
+    std::string name;
+    uint64_t size = 0;
+    int64_t mtime = 0;
+};
+
+struct DirectoryRecord {
+    int64_t mtime = 0;
+    std::vector<FileRecord> files;
+    std::vector<std::string> subdirectories;
+};
+
+// Ключ - путь каталога относительно корня через '/'
+using Manifest = StringHashTable<DirectoryRecord>;
+
+std::string manifestPath(std::string_view rootDirectory)
+{
+    return std::format("{}/files_{:016x}.bin", AssetCache::kDirectory, std::hash<std::string_view>{}(rootDirectory));
+}
+
+// Манифест может оказаться недописанным или чужим, поэтому каждое чтение проверяет остаток данных
+Manifest loadManifest(std::string_view rootDirectory)
+{
+    Tracy_ZoneScoped;
+    using namespace IoUtils;
+
+    Manifest manifest;
+    if (!AssetCache::isEnabled())
+        return manifest;
+
+    MappedFile file = FileUtils::mapFile(manifestPath(rootDirectory));
+    std::span<const uint8_t> data = file.data();
+    size_t offset = 0;
+    auto has = [&] (size_t size) { return data.size() - offset >= size; };
+    auto readSizedString = [&] (std::string_view& outValue) {
+        if (!has(sizeof(uint32_t)))
+            return false;
+        size_t size = readUInt32(data, offset);
+        if (!has(size))
+            return false;
+        outValue = {(const char*)data.data() + offset, size};
+        offset += size;
+        return true;
+    };
+
+    std::string_view storedRoot;
+    if (!has(3 * sizeof(uint32_t)) || readUInt32(data, offset) != kMagic || readUInt32(data, offset) != kVersion)
+        return manifest;
+
+    uint32_t directoryCount = readUInt32(data, offset);
+    if (!readSizedString(storedRoot) || storedRoot != rootDirectory)
+        return manifest;
+
+    manifest.reserve(directoryCount);
+    for (uint32_t i = 0; i < directoryCount; ++i) {
+        std::string_view path;
+        if (!readSizedString(path) || !has(sizeof(int64_t) + 2 * sizeof(uint32_t)))
+            return {};
+
+        DirectoryRecord record;
+        record.mtime = readInt64(data, offset);
+        record.files.resize(readUInt32(data, offset));
+        record.subdirectories.resize(readUInt32(data, offset));
+        for (FileRecord& fileRecord : record.files) {
+            std::string_view name;
+            if (!readSizedString(name) || !has(sizeof(uint64_t) + sizeof(int64_t)))
+                return {};
+            fileRecord.name = name;
+            fileRecord.size = readUInt64(data, offset);
+            fileRecord.mtime = readInt64(data, offset);
+        }
+        for (std::string& subdirectory : record.subdirectories) {
+            std::string_view name;
+            if (!readSizedString(name))
+                return {};
+            subdirectory = name;
+        }
+        manifest.emplace(path, std::move(record));
+    }
+    return manifest;
+}
+
+void saveManifest(std::string_view rootDirectory, const Manifest& manifest)
+{
+    Tracy_ZoneScoped;
+    using namespace IoUtils;
+    if (!AssetCache::isEnabled())
+        return;
+
+    std::vector<uint8_t> blob;
+    writeUInt32(blob, kMagic);
+    writeUInt32(blob, kVersion);
+    writeUInt32(blob, (uint32_t)manifest.size());
+    writeStringWithSize(blob, rootDirectory);
+    for (const auto& [path, record] : manifest) {
+        writeStringWithSize(blob, path);
+        writeInt64(blob, record.mtime);
+        writeUInt32(blob, (uint32_t)record.files.size());
+        writeUInt32(blob, (uint32_t)record.subdirectories.size());
+        for (const FileRecord& fileRecord : record.files) {
+            writeStringWithSize(blob, fileRecord.name);
+            writeUInt64(blob, fileRecord.size);
+            writeInt64(blob, fileRecord.mtime);
+        }
+        for (const std::string& subdirectory : record.subdirectories) {
+            writeStringWithSize(blob, subdirectory);
+        }
+    }
+
+    std::error_code ec;
+    fs::create_directories(StringUtils::toUtf8View(AssetCache::kDirectory), ec);
+
+    // Запись во временный файл и переименование, как в AssetCache
+    const std::string path = manifestPath(rootDirectory);
+    const std::string tempPath = path + ".tmp";
+    std::string error;
+    if (!FileUtils::saveFile(tempPath, blob, &error)) {
+        LogFmt("FileIndex: write {} failed. {}", tempPath, error);
+        return;
+    }
+
+    fs::rename(StringUtils::toUtf8View(tempPath), StringUtils::toUtf8View(path), ec);
+    if (ec) {
+        LogFmt("FileIndex: rename {} failed. {}", tempPath, ec.message());
+        fs::remove(StringUtils::toUtf8View(tempPath), ec);
+    }
+}
+
+uint8_t scopeKinds(std::string_view relativePath)
+{
+    uint8_t kinds = 0;
+    for (const Scope& scope : kScopes) {
+        if (scope.directory == relativePath)
+            kinds |= scope.kind;
+    }
+    return kinds;
+}
+
+bool isNestedScope(const Scope& scope)
+{
+    return std::any_of(std::begin(kScopes), std::end(kScopes), [&scope] (const Scope& other) {
+        return scope.directory.size() > other.directory.size() &&
+               scope.directory.starts_with(other.directory) &&
+               scope.directory[other.directory.size()] == '/';
+    });
+}
+
+bool matchesKind(std::string_view fileName, FileKind kind)
+{
+    switch (kind) {
+    case kCsx: return fileName.ends_with(".csx");
+    case kSdb: return fileName.ends_with(".sdb");
+    case kMdf: return fileName.ends_with(".mdf");
+    case kCs:  return fileName.ends_with(".cs");
+    }
+    return false;
+}
+
+// Параллельный обход. У каждого потока своя очередь: свои каталоги берутся с конца (обход в глубину),
+// при пустой очереди каталог перехватывается из начала чужой
+class DirectoryWalker
+{
+public:
+    struct Job {
+        std::string relativePath;
+        uint8_t kinds = 0;
+    };
+
+    DirectoryWalker(std::string_view rootDirectory, const Manifest& previous, size_t workerCount) :
+        m_rootDirectory(rootDirectory),
+        m_previous(previous),
+        m_workers(workerCount)
+    {}
+
+    void push(size_t worker, Job job) {
+        ++m_pendingJobs;
+        {
+            std::lock_guard lock(m_workers[worker].mutex);
+            m_workers[worker].jobs.push_back(std::move(job));
+        }
+        {
+            std::lock_guard lock(m_idleMutex);
+            ++m_queuedJobs;
+        }
+        m_idleCondition.notify_one();
+    }
+
+    void run(size_t worker) {
+        Tracy_ZoneScoped;
+        Job job;
+        while (true) {
+            if (pop(worker, job)) {
+                process(worker, job);
+                if (--m_pendingJobs == 0) {
+                    std::lock_guard lock(m_idleMutex);
+                    m_idleCondition.notify_all();
+                }
+                continue;
+            }
+
+            // Очереди пусты, но другие потоки ещё могут добавить каталоги
+            std::unique_lock lock(m_idleMutex);
+            m_idleCondition.wait(lock, [this] { return m_queuedJobs > 0 || m_pendingJobs == 0; });
+            if (m_queuedJobs == 0 && m_pendingJobs == 0)
+                return;
+        }
+    }
+
+    // После завершения всех run()
+    void collect(ResourceFiles& outFiles, Manifest& outManifest, size_t& outChangedDirectories) {
+        outChangedDirectories = 0;
+        for (Worker& worker : m_workers) {
+            auto append = [] (std::vector<std::string>& to, std::vector<std::string>& from) {
+                to.insert(to.end(), std::make_move_iterator(from.begin()), std::make_move_iterator(from.end()));
+            };
+            append(outFiles.csxFiles, worker.files.csxFiles);
+            append(outFiles.sdbFiles, worker.files.sdbFiles);
+            append(outFiles.mdfFiles, worker.files.mdfFiles);
+            append(outFiles.csFiles, worker.files.csFiles);
+
+            for (auto& [path, record] : worker.directories) {
+                outManifest.insert_or_assign(std::move(path), std::move(record));
+            }
+            outChangedDirectories += worker.changedDirectories;
+        }
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+
+        ResourceFiles files;
+        std::vector<std::pair<std::string, DirectoryRecord>> directories;
+        size_t changedDirectories = 0;
+    };
+
+    bool pop(size_t worker, Job& outJob) {
+        for (size_t i = 0; i < m_workers.size(); ++i) {
+            Worker& victim = m_workers[(worker + i) % m_workers.size()];
+            std::lock_guard lock(victim.mutex);
+            if (victim.jobs.empty())
+                continue;
+
+            if (i == 0) {
+                outJob = std::move(victim.jobs.back());
+                victim.jobs.pop_back();
+            } else {
+                outJob = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+            }
+
+            std::lock_guard idleLock(m_idleMutex);
+            --m_queuedJobs;
+            return true;
+        }
+        return false;
+    }
+
+    void process(size_t workerIndex, const Job& job) {
+        Worker& worker = m_workers[workerIndex];
+        std::error_code ec;
+        const fs::path directory = fs::path(StringUtils::toUtf8View(m_rootDirectory)) / StringUtils::toUtf8View(job.relativePath);
+        const int64_t mtime = fs::last_write_time(directory, ec).time_since_epoch().count();
+        if (ec)
+            return;
+
+        DirectoryRecord record;
+        auto previousIt = m_previous.find(job.relativePath);
+        if (previousIt != m_previous.end() && previousIt->second.mtime == mtime) {
+            record = previousIt->second;
+        } else {
+            record = readDirectory(directory, mtime);
+            ++worker.changedDirectories;
+        }
+
+        for (const FileRecord& file : record.files) {
+            addFile(worker.files, job, file.name);
+        }
+
+        for (const std::string& subdirectory : record.subdirectories) {
+            std::string relativePath = std::format("{}/{}", job.relativePath, subdirectory);
+            uint8_t kinds = job.kinds | scopeKinds(relativePath);
+            push(workerIndex, {std::move(relativePath), kinds});
+        }
+
+        worker.directories.emplace_back(job.relativePath, std::move(record));
+    }
+
+    static DirectoryRecord readDirectory(const fs::path& directory, int64_t mtime) {
+        DirectoryRecord record;
+        record.mtime = mtime;
+
+        std::error_code ec;
+        for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+            const fs::directory_entry& entry = *it;
+            // Символические ссылки на каталоги не обходятся, как и в recursive_directory_iterator по умолчанию
+            if (entry.is_directory(ec) && !entry.is_symlink(ec)) {
+                record.subdirectories.push_back(entry.path().filename().string());
+            } else if (entry.is_regular_file(ec)) {
+                FileRecord& file = record.files.emplace_back();
+                file.name = entry.path().filename().string();
+                file.size = entry.file_size(ec);
+                file.mtime = entry.last_write_time(ec).time_since_epoch().count();
+            }
+        }
+        if (ec) {
+            LogFmt("FileIndex: read {} failed. {}", directory.string(), ec.message());
+        }
+        return record;
+    }
+
+    static void addFile(ResourceFiles& files, const Job& job, std::string_view fileName) {
+        if (job.kinds == 0)
+            return;
+
+        auto makePath = [&] {
+            std::string path = std::format("{}/{}", job.relativePath, fileName);
+            // Разделитель как у path::lexically_relative
+            if constexpr (fs::path::preferred_separator != '/') {
+                std::replace(path.begin(), path.end(), '/', (char)fs::path::preferred_separator);
+            }
+            return path;
+        };
+
+        if ((job.kinds & kCsx) && matchesKind(fileName, kCsx)) files.csxFiles.push_back(makePath());
+        if ((job.kinds & kSdb) && matchesKind(fileName, kSdb)) files.sdbFiles.push_back(makePath());
+        if ((job.kinds & kMdf) && matchesKind(fileName, kMdf)) files.mdfFiles.push_back(makePath());
+        if ((job.kinds & kCs)  && matchesKind(fileName, kCs))  files.csFiles.push_back(makePath());
+    }
+
+    std::string_view m_rootDirectory;
+    const Manifest& m_previous;
+    std::deque<Worker> m_workers; // Worker не перемещаемый (mutex)
+
+    std::atomic<size_t> m_pendingJobs{0}; // В очередях и в обработке
+    size_t m_queuedJobs = 0; // Под m_idleMutex
+    std::mutex m_idleMutex;
+    std::condition_variable m_idleCondition;
+};
+
+} // namespace
+
+ResourceFiles FileIndex::scan(std::string_view rootDirectory)
+{
+    Tracy_ZoneScoped;
+    const Manifest previous = loadManifest(rootDirectory);
+
+    ThreadPool& pool = ThreadPool::shared();
+    const size_t workerCount = pool.threadCount() + 1; // Вызывающий поток тоже обходит каталоги
+    DirectoryWalker walker(rootDirectory, previous, workerCount);
+
+    for (const Scope& scope : kScopes) {
+        if (!isNestedScope(scope)) {
+            walker.push(0, {std::string(scope.directory), scopeKinds(scope.directory)});
+        }
+    }
+
+    std::vector<std::future<void>> helpers;
+    helpers.reserve(workerCount - 1);
+    for (size_t worker = 1; worker < workerCount; ++worker) {
+        helpers.push_back(pool.submit([&walker, worker] { walker.run(worker); }));
+    }
+    walker.run(0);
+    for (std::future<void>& helper : helpers) {
+        helper.wait();
+    }
+
+    ResourceFiles files;
+    Manifest manifest;
+    size_t changedDirectories = 0;
+    walker.collect(files, manifest, changedDirectories);
+    LogFmt("FileIndex: {} directories, {} re-read", manifest.size(), changedDirectories);
+
+    // Каталоги, которых больше нет, тоже меняют манифест
+    if (changedDirectories > 0 || manifest.size() != previous.size()) {
+        saveManifest(rootDirectory, manifest);
+    }
+    return files;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <string_view>
+#include <string>
+#include <vector>
+
+// Файлы ресурсов игры по типам. Пути относительно корневого каталога, без сортировки
+struct ResourceFiles {
+    std::vector<std::string> csxFiles;
+    std::vector<std::string> sdbFiles;
+    std::vector<std::string> mdfFiles;
+    std::vector<std::string> csFiles;
+};
+
+// Индекс файлов ресурсов: один параллельный обход каталогов (очереди каталогов с перехватом работы
+// между потоками), все типы файлов распознаются за один проход.
+// Содержимое каталогов (имя, размер и время изменения файлов) сохраняется в манифест в AssetCache::kDirectory.
+// При следующем открытии того же каталога читаются только каталоги с изменившимся временем изменения,
+// для остальных достаточно одного stat
+class FileIndex
+{
+public:
+    FileIndex() = delete;
+
+    static ResourceFiles scan(std::string_view rootDirectory);
+};
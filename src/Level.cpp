@@ -1,148 +1,95 @@
 #include "Level.h"
 
-#include <filesystem>
 #include <algorithm>
 #include <cassert>
 #include <format>
 
-#include "graphics/TextureLoader.h"
 #include "utils/TracyProfiler.h"
-#include "utils/StringUtils.h"
-#include "utils/DebugLog.h"
+#include "LevelLoader.h"
 
 std::optional<Level> Level::loadLevel(SDL_Renderer* renderer, std::string_view rootDirectory, std::string_view levelName, LevelType levelType, std::string* error)
 {
     Tracy_ZoneScoped;
-    LogFmt("Loading level: {}", levelWindowName(levelName, levelType));
     assert(error);
 
-    Level levelObj;
-    auto& levelData = levelObj.m_data;
-    levelData.name = levelName;
-    levelData.type = levelType;
-    auto levelTypeString = levelTypeToString(levelType);
-
-    std::string sefPath = levelSef(rootDirectory, levelTypeString, levelName);
-    if (!SEF_Parser::parse(sefPath, levelData.sefData, error)) {
-        LogFmt("Loading .sef failed. {}", *error);
-        return {};
-    }
-
-    std::string lvlPath = levelLvl(rootDirectory, levelData.sefData.pack);
-    if (!LVL_Parser::parse(lvlPath, levelData.lvlData, error)) {
-        LogFmt("Loading .lvl failed. {}", *error);
-        return {};
-    }
-
-    std::string sdbPath = levelSdb(rootDirectory, levelTypeString, levelName);
-    if (!SDB_Parser::parse(sdbPath, levelData.sdbData, error)) {
-        LogFmt("Loading .sdb failed. {}", *error);
-        // Допустимо не загрузить. Нужно уведомить пользователя
-    }
-
-    std::string bgPath = levelBackground(rootDirectory, levelData.sefData.pack);
-    if (!TextureLoader::loadTextureFromFile(bgPath.c_str(), renderer, levelData.background, error)) {
-        LogFmt("Loading background failed. Error: {}", *error);
-        return {};
-    }
-
-    // TODO: Всегда генерировать миникарту из фона
-    std::string minimapPath = levelMinimap(rootDirectory, levelData.sefData.pack);
-    TextureLoader::loadTextureFromCsxFile(minimapPath.c_str(), renderer, levelData.minimap);
+    LevelLoader loader(renderer, rootDirectory, levelName, levelType);
+    loader.wait();
+    return loader.finish(renderer, error);
+}
 
-    std::string laoPath = levelLao(rootDirectory, levelData.sefData.pack);
-    if (std::filesystem::exists(StringUtils::toUtf8View(laoPath))) {
-        std::string laoError;
-        levelData.laoData = LAO_Parser::parse(laoPath, &laoError);
-        if (!levelData.laoData) {
-            LogFmt("Loading .lao failed. {}", laoError); // Допустимо
+void LevelSpatialIndex::build(const LevelData& data)
+{
+    Tracy_ZoneScoped;
+    std::vector<SpatialGrid::Rect> rects;
+    auto tileRect = [] (const TilePosition& position) -> SpatialGrid::Rect {
+        const float x = position.x * Level::tileWidth;
+        const float y = position.y * Level::tileHeight;
+        return {x, y, x + Level::tileWidth, y + Level::tileHeight};
+    };
+    auto buildCellGroups = [&] (const std::vector<CellGroup>& groups, SpatialGrid& grid) {
+        rects.clear();
+        for (const CellGroup& group : groups) {
+            SpatialGrid::Rect groupRect;
+            for (size_t i = 0; i < group.cells.size(); ++i) {
+                const SpatialGrid::Rect cellRect = tileRect(group.cells[i]);
+                if (i == 0) {
+                    groupRect = cellRect;
+                } else {
+                    groupRect.minX = std::min(groupRect.minX, cellRect.minX);
+                    groupRect.minY = std::min(groupRect.minY, cellRect.minY);
+                    groupRect.maxX = std::max(groupRect.maxX, cellRect.maxX);
+                    groupRect.maxY = std::max(groupRect.maxY, cellRect.maxY);
+                }
+            }
+            rects.push_back(groupRect);
         }
-    }
+        grid.build(rects);
+    };
 
-    // Валидация анимаций
-    int animationDescCount = levelData.lvlData.animationDescriptions.size();
-    int animationLaoCount = levelData.laoData ? levelData.laoData->infos.size() : 0;
-    int animationFilesCount = 0;
-    std::string levelAnimationDirPath = levelAnimationDir(rootDirectory, levelData.sefData.pack);
-    if (std::filesystem::exists(StringUtils::toUtf8View(levelAnimationDirPath))) {
-        animationFilesCount = std::distance(std::filesystem::directory_iterator(StringUtils::toUtf8View(levelAnimationDirPath)),
-                                            std::filesystem::directory_iterator{});
+    rects.clear();
+    for (const SEF_Person& person : data.sefData.persons) {
+        rects.push_back(tileRect(person.position));
     }
-    bool animationOk = animationDescCount == animationLaoCount && animationLaoCount == animationFilesCount;
-    if (!animationOk) {
-        LogFmt("Animation counts mismatch (animationDescCount: {}, animationLaoCount: {}, animationFilesCount: {})", animationDescCount, animationLaoCount, animationFilesCount);
-    }
-
-    int minimalAnimationSize = std::min(std::min(animationDescCount, animationLaoCount), animationFilesCount);
-    std::span<LVL_Description> animationDescriptionView(levelData.lvlData.animationDescriptions.data(), minimalAnimationSize);
+    persons.build(rects);
 
-    // Отсортируем описание анимаций
-    if (animationDescCount >= 2) {
-        std::sort(animationDescriptionView.begin(),
-                  animationDescriptionView.end(),
-                  [] (const LVL_Description& left, const LVL_Description& right) {
-                      return left.number < right.number;
-                  });
+    rects.clear();
+    for (const SEF_PointEntrance& pointEntrance : data.sefData.pointsEntrance) {
+        rects.push_back(tileRect(pointEntrance.position));
     }
-
-    for (int i = 0; i < minimalAnimationSize; ++i) {
-        std::string levelAnimationPath = levelAnimation(rootDirectory, levelData.sefData.pack, i);
-        LevelAnimation animation(levelData.lvlData.animationDescriptions.at(i));
-        assert(animation.description.number == i);
-        animation.delayMs = levelData.laoData->infos[i].delay;
-        if (!TextureLoader::loadHeightAnimationFromCsxFile(levelAnimationPath, levelData.laoData->infos[i].height, renderer, animation.textures, error)) {
-            LogFmt("Loading texture for animation failed. {}", *error);
-            return {};
+    pointsEntrance.build(rects);
+
+    buildCellGroups(data.sefData.cellGroups, sefCellGroups);
+    buildCellGroups(data.lvlData.cellGroups, lvlCellGroups);
+
+    rects.clear();
+    for (const LevelAnimation& animation : data.animations) {
+        const float x = animation.description.position.x;
+        const float y = animation.description.position.y;
+        int width = 0;
+        int height = 0;
+        for (const TextureRegion& frame : animation.frames) {
+            width = std::max(width, frame.w);
+            height = std::max(height, frame.h);
         }
-        levelData.animations.push_back(std::move(animation));
+        rects.push_back({x, y, x + width, y + height});
     }
+    animations.build(rects);
 
-    // Загрузка тригеров
-    int triggerDescCount = levelData.lvlData.triggerDescriptions.size();
-    int triggerFilesCount = 0;
-    std::string levelTriggerDirPath = levelTriggerDir(rootDirectory, levelData.sefData.pack);
-    if (std::filesystem::exists(StringUtils::toUtf8View(levelTriggerDirPath))) {
-        triggerFilesCount = std::distance(std::filesystem::directory_iterator(StringUtils::toUtf8View(levelTriggerDirPath)),
-                                          std::filesystem::directory_iterator{});
-    }
-    bool triggersOk = triggerFilesCount == triggerDescCount;
-    if (!triggersOk) {
-        LogFmt("Trigger counts mismatch (triggerDescCount: {}, triggerFilesCount: {})", triggerDescCount, triggerFilesCount);
+    rects.clear();
+    for (const ExtraSound& sound : data.lvlData.sounds.otherSounds) {
+        const float x = sound.chunkPositionX * Level::chunkWidth;
+        const float y = sound.chunkPositionY * Level::chunkHeight;
+        rects.push_back({x, y, x + Level::chunkWidth, y + Level::chunkHeight});
     }
+    sounds.build(rects);
 
-    for (int i = 0; i < levelData.lvlData.triggerDescriptions.size(); ++i) {
-        LVL_Description& lvlDescription = levelData.lvlData.triggerDescriptions.at(i);
-
-        std::string levelTriggerPath = levelTrigger(rootDirectory, levelData.sefData.pack, lvlDescription.number);
-        const Texture* triggerTexture
-                = levelData.imgui.triggerCache.load(levelTriggerPath,
-                                                    [&]() -> std::optional<Texture> {
-                                                        Texture texture;
-                                                        if (!TextureLoader::loadTextureFromCsxFile(levelTriggerPath, renderer, texture, error)) {
-                                                            return std::nullopt;
-                                                        }
-                                                        SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_ADD);
-                                                        return std::move(texture);
-                                                    });
-        if (triggerTexture) {
-            LevelTrigger trigger(lvlDescription, *triggerTexture);
-
-            if (auto it = std::find_if(levelData.sefData.triggers.begin(),
-                                       levelData.sefData.triggers.end(),
-                                       [&trigger](const SEF_Trigger& sefTrigger) {
-                                            return sefTrigger.techName == trigger.lvlDescription.name;
-                                       });
-                it != levelData.sefData.triggers.cend())
-            {
-                trigger.sefDescription = *it;
-            }
-            levelData.triggers.push_back(std::move(trigger));
-        } else {
-            LogFmt("Loading texture for trigger failed. {}", *error);
-        }
+    rects.clear();
+    for (const LevelTrigger& trigger : data.triggers) {
+        const float x = trigger.lvlDescription.position.x;
+        const float y = trigger.lvlDescription.position.y;
+        rects.push_back({x, y, x + trigger.region.w, y + trigger.region.h});
     }
-
-    return std::make_optional(std::move(levelObj));
+    triggers.build(rects);
 }
 
 std::string Level::levelWindowName(std::string_view levelName, LevelType levelType)
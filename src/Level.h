@@ -1,6 +1,7 @@
 #pragma once
 #include <string_view>
 #include <optional>
+#include <array>
 
 #include "imgui.h"
 
@@ -10,7 +11,8 @@
 #include "parsers/LAO_Parser.h"
 #include "graphics/Texture.h"
 #include "graphics/Animation.h"
-#include "Cache.h"
+#include "graphics/TextureAtlas.h"
+#include "utils/SpatialGrid.h"
 #include "Types.h"
 
 enum class MapTilesMode {
@@ -70,11 +72,10 @@ struct LevelImgui {
     std::optional<int> highlightCellGroudIndex;
 
     bool showAnimations = true;
-    bool hasVisibleAnimations = false;
+    uint64_t nextAnimationFrameMs = 0; // Ближайшая смена кадра видимых анимаций (SDL_GetTicks), 0 - нет
 
     bool showSounds = false;
 
-    Cache<Texture> triggerCache;
     bool showTriggers = false;
 
     bool showObjectsList = false;
@@ -98,13 +99,29 @@ struct LevelAnimation : public Animation {
 };
 
 struct LevelTrigger {
-    LevelTrigger(LVL_Description& description, const Texture& texture) :
+    LevelTrigger(LVL_Description& description, const TextureRegion& region) :
         lvlDescription(description),
-        texture(texture) {}
+        region(region) {}
 
     LVL_Description& lvlDescription;  // Из lvlData
     std::optional<std::reference_wrapper<SEF_Trigger>> sefDescription;
-    const Texture& texture;
+    TextureRegion region;  // Из triggerAtlas
+};
+
+struct LevelData;
+
+// Сетки объектов уровня в пикселях от левого верхнего угла уровня, строятся при загрузке.
+// Индексы в сетках совпадают с индексами в массивах LevelData
+struct LevelSpatialIndex {
+    SpatialGrid persons;        // sefData.persons
+    SpatialGrid pointsEntrance; // sefData.pointsEntrance
+    SpatialGrid sefCellGroups;  // sefData.cellGroups, по описывающему прямоугольнику клеток
+    SpatialGrid lvlCellGroups;  // lvlData.cellGroups
+    SpatialGrid animations;     // animations, по объединению всех кадров
+    SpatialGrid sounds;         // lvlData.sounds.otherSounds
+    SpatialGrid triggers;       // triggers
+
+    void build(const LevelData& data);
 };
 
 struct LevelData {
@@ -113,12 +130,16 @@ struct LevelData {
 
     Texture background;
     Texture minimap;
+    std::array<Texture, 3> mapTilesOverlays; // По текстуре на MapTilesMode, тексель на тайл. Создаются при первом показе
     SEF_Data sefData;
     LVL_Data lvlData;
     SDB_Data sdbData;
     std::optional<LAO_Data> laoData;
     std::vector<LevelAnimation> animations;
     std::vector<LevelTrigger> triggers;
+    TextureAtlas animationAtlas;
+    TextureAtlas triggerAtlas;
+    LevelSpatialIndex spatialIndex;
     LevelImgui imgui;
 };
 
@@ -136,6 +157,7 @@ public:
     const LevelData& data() const { return m_data; }
     LevelData& data() { return m_data; }
 
+    // Синхронная загрузка. Для загрузки без блокировки UI используется LevelLoader
     static std::optional<Level> loadLevel(SDL_Renderer* renderer, std::string_view rootDirectory, std::string_view levelName, LevelType levelType, std::string* error);
 
     static std::string levelWindowName(std::string_view levelName, LevelType levelType);
@@ -152,6 +174,8 @@ public:
     static const int chunkHeight = tileHeight * 2;
 
 private:
+    friend class LevelLoader;
+
     Level() noexcept = default;
 
     static std::string levelSef(std::string_view rootDirectory, std::string_view levelType, std::string_view levelName);
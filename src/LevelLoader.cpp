@@ -0,0 +1,337 @@
+#include "LevelLoader.h"
+
+#include <filesystem>
+#include <algorithm>
+#include <cassert>
+#include <deque>
+
+#include "graphics/TextureLoader.h"
+#include "utils/TracyProfiler.h"
+#include "utils/StringUtils.h"
+#include "utils/ThreadPool.h"
+#include "utils/DebugLog.h"
+
+LevelLoader::LevelLoader(SDL_Renderer* renderer, std::string_view rootDirectory, std::string_view levelName, LevelType levelType) :
+    m_rootDirectory(rootDirectory),
+    m_levelName(levelName),
+    m_levelType(levelType),
+    m_have16BitSupport(TextureLoader::have16BitSupport(renderer))
+{
+    LogFmt("Loading level: {}", Level::levelWindowName(levelName, levelType));
+    m_level.m_data.name = levelName;
+    m_level.m_data.type = levelType;
+
+    m_decodeFuture = std::async(std::launch::async, [this] () {
+        bool isOk = decode();
+        m_isDecoded = true;
+        return isOk;
+    });
+}
+
+LevelLoader::~LevelLoader()
+{
+    if (m_decodeFuture.valid())
+        m_decodeFuture.wait();
+}
+
+float LevelLoader::progress() const
+{
+    float progress = 0.0f;
+    for (int stage = 0; stage < kStageCount; ++stage) {
+        const int total = m_stages[stage].total;
+        if (total < 0)
+            continue;
+
+        const float stageProgress = (total == 0) ? 1.0f : static_cast<float>(m_stages[stage].done) / static_cast<float>(total);
+        progress += kStageWeights[stage] * stageProgress;
+    }
+    return std::min(progress, 1.0f);
+}
+
+void LevelLoader::wait() const
+{
+    if (m_decodeFuture.valid())
+        m_decodeFuture.wait();
+}
+
+void LevelLoader::beginStage(Stage stage, int taskCount)
+{
+    assert(m_stages[stage].total < 0);
+    m_stages[stage].total = taskCount;
+}
+
+template<class Task>
+std::future<bool> LevelLoader::submitTask(Stage stage, Task&& task)
+{
+    assert(m_stages[stage].total > 0);
+    return ThreadPool::shared().submit([this, stage, task = std::forward<Task>(task)] () mutable {
+        bool isOk = task();
+        ++m_stages[stage].done;
+        return isOk;
+    });
+}
+
+bool LevelLoader::decode()
+{
+    Tracy_ZoneScoped;
+    LevelData& levelData = m_level.m_data;
+    auto levelTypeString = levelTypeToString(m_levelType);
+    const std::string& pack = levelData.sefData.pack; // Заполняется на первом этапе
+
+    std::string sefError;
+    std::string lvlError;
+    std::string backgroundError;
+    std::vector<std::string> animationErrors;
+
+    // Задачи ссылаются на данные загрузчика, поэтому перед выходом дожидаемся их всех
+    std::deque<std::future<bool>> tasks;
+    struct WaitGuard {
+        std::deque<std::future<bool>>& tasks;
+        ~WaitGuard() {
+            for (auto& task : tasks) {
+                if (task.valid())
+                    task.wait();
+            }
+        }
+    } waitGuard{tasks};
+
+    // Этап 1: sef и sdb не зависят друг от друга
+    beginStage(kStageHeaders, 2);
+    std::future<bool>& sefTask = tasks.emplace_back(submitTask(kStageHeaders, [&] () {
+        std::string sefPath = Level::levelSef(m_rootDirectory, levelTypeString, m_levelName);
+        return SEF_Parser::parse(sefPath, levelData.sefData, &sefError);
+    }));
+
+    tasks.emplace_back(submitTask(kStageHeaders, [&] () {
+        std::string sdbPath = Level::levelSdb(m_rootDirectory, levelTypeString, m_levelName);
+        std::string sdbError;
+        if (!SDB_Parser::parse(sdbPath, levelData.sdbData, &sdbError)) {
+            LogFmt("Loading .sdb failed. {}", sdbError);
+            // Допустимо не загрузить. Нужно уведомить пользователя
+        }
+        return true;
+    }));
+
+    if (!sefTask.get()) {
+        LogFmt("Loading .sef failed. {}", sefError);
+        m_error = std::move(sefError);
+        return false;
+    }
+
+    // Этап 2: всё остальное зависит от pack из sef
+    beginStage(kStageLevel, 4);
+    std::future<bool>& lvlTask = tasks.emplace_back(submitTask(kStageLevel, [&] () {
+        std::string lvlPath = Level::levelLvl(m_rootDirectory, pack);
+        return LVL_Parser::parse(lvlPath, levelData.lvlData, &lvlError);
+    }));
+
+    std::future<bool>& laoTask = tasks.emplace_back(submitTask(kStageLevel, [&] () {
+        std::string laoPath = Level::levelLao(m_rootDirectory, pack);
+        if (std::filesystem::exists(StringUtils::toUtf8View(laoPath))) {
+            std::string laoError;
+            levelData.laoData = LAO_Parser::parse(laoPath, &laoError);
+            if (!levelData.laoData) {
+                LogFmt("Loading .lao failed. {}", laoError); // Допустимо
+            }
+        }
+        return true;
+    }));
+
+    std::future<bool>& backgroundTask = tasks.emplace_back(submitTask(kStageLevel, [&] () {
+        std::string bgPath = Level::levelBackground(m_rootDirectory, pack);
+        m_background = TextureLoader::decodeImageFromFile(bgPath, m_have16BitSupport, &backgroundError);
+        return m_background != nullptr;
+    }));
+
+    // TODO: Всегда генерировать миникарту из фона
+    tasks.emplace_back(submitTask(kStageLevel, [&] () {
+        std::string minimapPath = Level::levelMinimap(m_rootDirectory, pack);
+        TextureLoader::decodeCsxFile(minimapPath, m_minimap);
+        return true;
+    }));
+
+    if (!lvlTask.get()) {
+        LogFmt("Loading .lvl failed. {}", lvlError);
+        m_error = std::move(lvlError);
+        return false;
+    }
+    laoTask.get();
+
+    // Валидация анимаций
+    int animationDescCount = levelData.lvlData.animationDescriptions.size();
+    int animationLaoCount = levelData.laoData ? levelData.laoData->infos.size() : 0;
+    int animationFilesCount = 0;
+    std::string levelAnimationDirPath = Level::levelAnimationDir(m_rootDirectory, pack);
+    if (std::filesystem::exists(StringUtils::toUtf8View(levelAnimationDirPath))) {
+        animationFilesCount = std::distance(std::filesystem::directory_iterator(StringUtils::toUtf8View(levelAnimationDirPath)),
+                                            std::filesystem::directory_iterator{});
+    }
+    bool animationOk = animationDescCount == animationLaoCount && animationLaoCount == animationFilesCount;
+    if (!animationOk) {
+        LogFmt("Animation counts mismatch (animationDescCount: {}, animationLaoCount: {}, animationFilesCount: {})", animationDescCount, animationLaoCount, animationFilesCount);
+    }
+
+    int minimalAnimationSize = std::min(std::min(animationDescCount, animationLaoCount), animationFilesCount);
+    std::span<LVL_Description> animationDescriptionView(levelData.lvlData.animationDescriptions.data(), minimalAnimationSize);
+
+    // Отсортируем описание анимаций
+    if (animationDescCount >= 2) {
+        std::sort(animationDescriptionView.begin(),
+                  animationDescriptionView.end(),
+                  [] (const LVL_Description& left, const LVL_Description& right) {
+                      return left.number < right.number;
+                  });
+    }
+
+    int triggerDescCount = levelData.lvlData.triggerDescriptions.size();
+    int triggerFilesCount = 0;
+    std::string levelTriggerDirPath = Level::levelTriggerDir(m_rootDirectory, pack);
+    if (std::filesystem::exists(StringUtils::toUtf8View(levelTriggerDirPath))) {
+        triggerFilesCount = std::distance(std::filesystem::directory_iterator(StringUtils::toUtf8View(levelTriggerDirPath)),
+                                          std::filesystem::directory_iterator{});
+    }
+    bool triggersOk = triggerFilesCount == triggerDescCount;
+    if (!triggersOk) {
+        LogFmt("Trigger counts mismatch (triggerDescCount: {}, triggerFilesCount: {})", triggerDescCount, triggerFilesCount);
+    }
+
+    // Несколько описаний могут ссылаться на один файл, декодируем его один раз
+    for (const LVL_Description& lvlDescription : levelData.lvlData.triggerDescriptions) {
+        bool isDuplicate = std::any_of(m_triggers.cbegin(), m_triggers.cend(), [&lvlDescription] (const DecodedTrigger& trigger) {
+            return trigger.number == lvlDescription.number;
+        });
+        if (!isDuplicate) {
+            m_triggers.emplace_back().number = lvlDescription.number;
+        }
+    }
+
+    // Этап 3: декодирование кадров анимаций и тригеров. Размеры векторов дальше не меняются
+    beginStage(kStageFrames, minimalAnimationSize + static_cast<int>(m_triggers.size()));
+    m_animationFrames.resize(minimalAnimationSize);
+    animationErrors.resize(minimalAnimationSize);
+    std::vector<std::future<bool>*> animationTasks;
+    animationTasks.reserve(minimalAnimationSize);
+    for (int i = 0; i < minimalAnimationSize; ++i) {
+        animationTasks.push_back(&tasks.emplace_back(submitTask(kStageFrames, [&, i] () {
+            std::string levelAnimationPath = Level::levelAnimation(m_rootDirectory, pack, i);
+            int height = levelData.laoData->infos[i].height;
+            return TextureLoader::decodeHeightAnimationFromCsxFile(levelAnimationPath, height, m_animationFrames[i], &animationErrors[i]);
+        })));
+    }
+
+    for (DecodedTrigger& decodedTrigger : m_triggers) {
+        tasks.emplace_back(submitTask(kStageFrames, [&, trigger = &decodedTrigger] () {
+            std::string levelTriggerPath = Level::levelTrigger(m_rootDirectory, pack, trigger->number);
+            trigger->isDecoded = TextureLoader::decodeCsxFile(levelTriggerPath, trigger->image, &trigger->error);
+            return true;
+        }));
+    }
+
+    if (!backgroundTask.get()) {
+        LogFmt("Loading background failed. Error: {}", backgroundError);
+        m_error = std::move(backgroundError);
+        return false;
+    }
+
+    for (int i = 0; i < minimalAnimationSize; ++i) {
+        if (!animationTasks[i]->get()) {
+            LogFmt("Loading texture for animation failed. {}", animationErrors[i]);
+            m_error = std::move(animationErrors[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::optional<Level> LevelLoader::finish(SDL_Renderer* renderer, std::string* error)
+{
+    Tracy_ZoneScoped;
+    assert(error);
+    assert(m_decodeFuture.valid());
+
+    if (!m_decodeFuture.get()) {
+        *error = std::move(m_error);
+        return {};
+    }
+
+    LevelData& levelData = m_level.m_data;
+
+    levelData.background = Texture::createFromSurface(renderer, m_background.get(), error);
+    if (!levelData.background) {
+        LogFmt("Loading background failed. Error: {}", *error);
+        return {};
+    }
+    m_background.reset();
+
+    if (m_minimap.isValid()) {
+        levelData.minimap = TextureLoader::createTextureFromIndexedFrame(m_minimap, 0, renderer);
+        m_minimap = {};
+    }
+
+    // Все кадры всех анимаций упаковываются в несколько страниц атласа
+    std::vector<const IndexedImage*> atlasImages;
+    atlasImages.reserve(m_animationFrames.size());
+    for (const IndexedImage& frames : m_animationFrames) {
+        atlasImages.push_back(&frames);
+    }
+    std::vector<std::vector<TextureRegion>> atlasRegions;
+    if (!levelData.animationAtlas.build(renderer, atlasImages, SDL_BLENDMODE_BLEND, atlasRegions, error)) {
+        LogFmt("Building animation atlas failed. {}", *error);
+        return {};
+    }
+    m_animationFrames.clear();
+
+    for (size_t i = 0; i < atlasRegions.size(); ++i) {
+        LevelAnimation animation(levelData.lvlData.animationDescriptions.at(i));
+        assert(static_cast<size_t>(animation.description.number) == i);
+        animation.delayMs = levelData.laoData->infos[i].delay;
+        animation.frames = std::move(atlasRegions[i]);
+        levelData.animations.push_back(std::move(animation));
+    }
+
+    // Загрузка тригеров. Одинаковые номера декодированы один раз и делят область атласа
+    atlasImages.clear();
+    for (const DecodedTrigger& decoded : m_triggers) {
+        if (decoded.isDecoded) {
+            atlasImages.push_back(&decoded.image);
+        }
+    }
+    if (!levelData.triggerAtlas.build(renderer, atlasImages, SDL_BLENDMODE_ADD, atlasRegions, error)) {
+        LogFmt("Building trigger atlas failed. {}", *error);
+        return {};
+    }
+
+    for (LVL_Description& lvlDescription : levelData.lvlData.triggerDescriptions) {
+        auto decoded = std::find_if(m_triggers.begin(), m_triggers.end(), [&lvlDescription] (const DecodedTrigger& trigger) {
+            return trigger.number == lvlDescription.number;
+        });
+        assert(decoded != m_triggers.end());
+
+        if (!decoded->isDecoded) {
+            LogFmt("Loading texture for trigger failed. {}", decoded->error);
+            continue;
+        }
+
+        size_t regionIndex = std::count_if(m_triggers.begin(), decoded, [] (const DecodedTrigger& trigger) {
+            return trigger.isDecoded;
+        });
+        LevelTrigger trigger(lvlDescription, atlasRegions[regionIndex].front());
+
+        if (auto it = std::find_if(levelData.sefData.triggers.begin(),
+                                   levelData.sefData.triggers.end(),
+                                   [&trigger](const SEF_Trigger& sefTrigger) {
+                                        return sefTrigger.techName == trigger.lvlDescription.name;
+                                   });
+            it != levelData.sefData.triggers.cend())
+        {
+            trigger.sefDescription = *it;
+        }
+        levelData.triggers.push_back(std::move(trigger));
+    }
+    m_triggers.clear();
+
+    levelData.spatialIndex.build(levelData);
+
+    return std::make_optional(std::move(m_level));
+}
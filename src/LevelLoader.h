@@ -0,0 +1,86 @@
+#pragma once
+#include <string_view>
+#include <optional>
+#include <array>
+#include <future>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "graphics/IndexedImage.h"
+#include "graphics/Surface.h"
+#include "Level.h"
+#include "Types.h"
+
+struct SDL_Renderer;
+
+// Асинхронная загрузка уровня.
+// Чтение файлов, разбор и декодирование изображений выполняются в пуле потоков,
+// в потоке рендера остаётся только создание текстур (finish)
+class LevelLoader
+{
+public:
+    LevelLoader(SDL_Renderer* renderer, std::string_view rootDirectory, std::string_view levelName, LevelType levelType);
+    ~LevelLoader();
+
+    LevelLoader(const LevelLoader&) = delete;
+    LevelLoader& operator=(const LevelLoader&) = delete;
+    LevelLoader(LevelLoader&&) = delete;
+    LevelLoader& operator=(LevelLoader&&) = delete;
+
+    std::string_view rootDirectory() const { return m_rootDirectory; }
+    std::string_view levelName() const { return m_levelName; }
+    LevelType levelType() const { return m_levelType; }
+
+    bool isDecoded() const { return m_isDecoded; }
+    // Не убывает: у каждого этапа своя доля, число задач этапа известно до запуска первой из них
+    float progress() const;
+    void wait() const;
+
+    // Вызывать из потока рендера после isDecoded()
+    std::optional<Level> finish(SDL_Renderer* renderer, std::string* error);
+
+private:
+    struct DecodedTrigger {
+        uint32_t number = 0; // LVL_Description::number
+        bool isDecoded = false;
+        IndexedImage image;
+        std::string error;
+    };
+
+    enum Stage {
+        kStageHeaders, // sef, sdb
+        kStageLevel,   // lvl, lao, фон, миникарта
+        kStageFrames,  // Кадры анимаций и тригеры
+        kStageCount
+    };
+    static constexpr std::array<float, kStageCount> kStageWeights = {0.05f, 0.35f, 0.6f};
+
+    struct StageProgress {
+        std::atomic<int> done{0};
+        std::atomic<int> total{-1}; // -1 - этап не начат
+    };
+
+    bool decode();
+
+    void beginStage(Stage stage, int taskCount);
+    template<class Task>
+    std::future<bool> submitTask(Stage stage, Task&& task);
+
+    std::string m_rootDirectory;
+    std::string m_levelName;
+    LevelType m_levelType;
+    bool m_have16BitSupport = false;
+
+    Level m_level;
+    std::string m_error;
+
+    SurfacePtr m_background;
+    IndexedImage m_minimap;
+    std::vector<IndexedImage> m_animationFrames;
+    std::vector<DecodedTrigger> m_triggers;
+
+    std::array<StageProgress, kStageCount> m_stages;
+    std::atomic<bool> m_isDecoded{false};
+    std::future<bool> m_decodeFuture;
+};
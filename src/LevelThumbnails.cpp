@@ -0,0 +1,166 @@
+#include "LevelThumbnails.h"
+
+#include <format>
+#include <chrono>
+
+#include "embedded_resources.h"
+#include "graphics/TextureLoader.h"
+#include "parsers/SEF_Parser.h"
+#include "utils/TracyProfiler.h"
+#include "utils/StringUtils.h"
+#include "utils/ThreadPool.h"
+#include "utils/FileUtils.h"
+#include "utils/DebugLog.h"
+
+LevelThumbnails::~LevelThumbnails()
+{
+    waitAll();
+}
+
+void LevelThumbnails::setRootDirectory(std::string_view rootDirectory, SDL_Renderer* renderer)
+{
+    if (rootDirectory == m_rootDirectory && !m_rootDirectory.empty())
+        return;
+
+    waitAll();
+    m_levels.clear();
+    m_packs.clear();
+    m_rootDirectory = rootDirectory;
+    m_have16BitSupport = TextureLoader::have16BitSupport(renderer);
+}
+
+void LevelThumbnails::prefetch(LevelType levelType, std::string_view levelName)
+{
+    std::string key = levelKey(levelType, levelName);
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_levels.contains(key))
+            return;
+        m_levels.emplace(key, LevelEntry{});
+    }
+
+    m_tasks.push_back(ThreadPool::shared().submit([this, key = std::move(key), levelType, levelName = std::string(levelName)] () mutable {
+        decode(std::move(key), levelType, std::move(levelName));
+    }));
+}
+
+const Texture* LevelThumbnails::texture(LevelType levelType, std::string_view levelName, SDL_Renderer* renderer, TextureCache& textureCache)
+{
+    std::unique_lock lock(m_mutex);
+    auto levelIt = m_levels.find(levelKey(levelType, levelName));
+    if (levelIt == m_levels.end()) {
+        lock.unlock();
+        prefetch(levelType, levelName);
+        return nullptr;
+    }
+
+    const LevelEntry& level = levelIt->second;
+    if (!level.isResolved)
+        return nullptr;
+
+    if (!level.pack.empty()) {
+        PackEntry& pack = m_packs.at(level.pack);
+        if (!pack.isDecoded)
+            return nullptr;
+
+        if (!pack.texture && pack.surface) {
+            char pathBuffer[768];
+            StringUtils::formatToBuffer(pathBuffer, "{}/levels/pack/{}/bitmaps/layer.jpg", m_rootDirectory, level.pack);
+            pack.texture = textureCache.load(pathBuffer, "thumbnail", [&]() -> std::optional<TextureSet> {
+                std::string error;
+                Texture texture = Texture::createFromSurface(renderer, pack.surface.get(), &error);
+                if (!texture) {
+                    LogFmt("createFromSurface error: {}", error);
+                    return std::nullopt;
+                }
+                TextureSet result;
+                result.push_back(std::move(texture));
+                return result;
+            });
+            pack.surface.reset();
+        }
+
+        if (pack.texture)
+            return &pack.texture->front();
+    }
+
+    // Заглушка для уровней без миниатюры
+    if (!m_fallback) {
+        m_fallback = textureCache.load("embedded/question.bmp", {}, [&]() -> std::optional<TextureSet> {
+            std::string error;
+            TextureSet result(1);
+            if (!TextureLoader::loadTextureFromMemory({question_bmp, question_bmp_size}, renderer, result.front(), &error)) {
+                LogFmt("loadTextureFromMemory error: {}", error);
+                return std::nullopt;
+            }
+            return result;
+        });
+    }
+    return m_fallback ? &m_fallback->front() : nullptr;
+}
+
+bool LevelThumbnails::isLoading() const
+{
+    std::erase_if(m_tasks, [] (const std::future<void>& task) {
+        return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+    return !m_tasks.empty();
+}
+
+std::string LevelThumbnails::levelKey(LevelType levelType, std::string_view levelName)
+{
+    return std::format("{}/{}", levelTypeToString(levelType), levelName);
+}
+
+void LevelThumbnails::decode(std::string key, LevelType levelType, std::string levelName)
+{
+    Tracy_ZoneScoped;
+    std::string error;
+    char pathBuffer[768];
+    StringUtils::formatToBuffer(pathBuffer, "{0}/levels/{1}/{2}/{2}.sef", m_rootDirectory, levelTypeToString(levelType), levelName);
+
+    char pack[32];
+    bool packParseOk = SEF_Parser::fastPackParse(pathBuffer, pack, &error);
+    if (!packParseOk) {
+        LogFmt("fastPackParse error: {}", error);
+    }
+
+    // Пак декодирует первая дошедшая до него задача
+    bool needDecode = false;
+    {
+        std::lock_guard lock(m_mutex);
+        LevelEntry& level = m_levels[key];
+        level.isResolved = true;
+        if (packParseOk) {
+            level.pack = pack;
+            needDecode = m_packs.try_emplace(level.pack).second;
+        }
+    }
+    if (!needDecode)
+        return;
+
+    StringUtils::formatToBuffer(pathBuffer, "{}/levels/pack/{}/bitmaps/layer.jpg", m_rootDirectory, pack);
+    SurfacePtr surface;
+    auto previewBuffer = FileUtils::loadJpegPhotoshopThumbnail(pathBuffer, &error);
+    if (!previewBuffer.empty()) {
+        surface = TextureLoader::decodeImageFromMemory(previewBuffer, m_have16BitSupport, &error);
+        if (!surface) {
+            LogFmt("decodeImageFromMemory error: {}", error);
+        }
+    } else {
+        LogFmt("loadJpegPhotoshopThumbnail error: {}", error);
+    }
+
+    std::lock_guard lock(m_mutex);
+    PackEntry& packEntry = m_packs.at(pack);
+    packEntry.surface = std::move(surface);
+    packEntry.isDecoded = true;
+}
+
+void LevelThumbnails::waitAll()
+{
+    for (std::future<void>& task : m_tasks) {
+        task.wait();
+    }
+    m_tasks.clear();
+}
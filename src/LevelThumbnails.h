@@ -0,0 +1,60 @@
+#pragma once
+#include <string_view>
+#include <future>
+#include <string>
+#include <vector>
+#include <mutex>
+
+#include "graphics/TextureCache.h"
+#include "graphics/Surface.h"
+#include "Types.h"
+
+struct SDL_Renderer;
+
+// Миниатюры уровней для LevelPicker.
+// Имя пака и миниатюра из layer.jpg читаются и декодируются в пуле потоков, текстура создаётся при первом показе.
+// Результаты хранятся до смены корневого каталога, уровни одного пака делят одну миниатюру
+class LevelThumbnails
+{
+public:
+    LevelThumbnails() noexcept = default;
+    ~LevelThumbnails();
+
+    LevelThumbnails(const LevelThumbnails&) = delete;
+    LevelThumbnails& operator=(const LevelThumbnails&) = delete;
+
+    // Сбрасывает результаты, если изменился корневой каталог
+    void setRootDirectory(std::string_view rootDirectory, SDL_Renderer* renderer);
+
+    void prefetch(LevelType levelType, std::string_view levelName);
+
+    // nullptr, пока миниатюра декодируется. Если у уровня нет миниатюры, возвращается заглушка
+    const Texture* texture(LevelType levelType, std::string_view levelName, SDL_Renderer* renderer, TextureCache& textureCache);
+
+    bool isLoading() const;
+
+private:
+    struct LevelEntry {
+        bool isResolved = false;
+        std::string pack; // Пустой, если пак не найден
+    };
+
+    struct PackEntry {
+        bool isDecoded = false;
+        SurfacePtr surface; // До создания текстуры
+        TextureHandle texture;
+    };
+
+    static std::string levelKey(LevelType levelType, std::string_view levelName);
+    void decode(std::string key, LevelType levelType, std::string levelName);
+    void waitAll();
+
+    std::string m_rootDirectory;
+    bool m_have16BitSupport = false;
+
+    mutable std::mutex m_mutex;
+    StringHashTable<LevelEntry> m_levels;
+    StringHashTable<PackEntry> m_packs;
+    mutable std::vector<std::future<void>> m_tasks;
+    TextureHandle m_fallback;
+};
@@ -2,7 +2,6 @@
 
 #include <filesystem>
 #include <format>
-#include <future>
 
 #include "parsers/SDB_Parser.h"
 #include "CsExecutor.h"
@@ -72,28 +71,10 @@ std::vector<std::string> Resources::levelNames(LevelType type) const
     return results;
 }
 
-std::vector<std::string> Resources::sdbFiles() const
+ResourceFiles Resources::files() const
 {
     Tracy_ZoneScoped;
-    return filesWithExtension({Levels_Single, Levels_Multiplayer, Sdb}, ".sdb");
-}
-
-std::vector<std::string> Resources::csxFiles() const
-{
-    Tracy_ZoneScoped;
-    return filesWithExtensionAsync({Engineres, Levels_Pack, Magic_Bitmap, Persons, Wear}, ".csx");
-}
-
-std::vector<std::string> Resources::mdfFiles() const
-{
-    Tracy_ZoneScoped;
-    return filesWithExtension({Magic}, ".mdf"); // TODO: fs::directory_iterator
-}
-
-std::vector<std::string> Resources::csFiles() const
-{
-    Tracy_ZoneScoped;
-    return filesWithExtension({Scripts_Dialogs}, ".cs");
+    return FileIndex::scan(m_rootDirectory);
 }
 
 StringHashTable<std::string> Resources::levelHumanNameDictionary() const
@@ -153,7 +134,7 @@ StringHashTable<std::string> Resources::levelHumanNameDictionary() const
     return result;
 }
 
-std::map<int, std::string> Resources::dialogPhrases() const
+SDB_Strings Resources::dialogPhrases() const
 {
     Tracy_ZoneScoped;
     std::string error;
@@ -176,48 +157,3 @@ StringHashTable<AgeVariable_t> Resources::globalVars() const
 
     return globalVars;
 }
-
-std::vector<std::string> Resources::Resources::filesWithExtension(std::initializer_list<int> indices, std::string_view extension) const {
-    std::vector<std::string> files;
-    for (int index : indices) {
-        auto dir = StringUtils::toUtf8View(m_mainDirectories[index]);
-        if (!fs::is_directory(dir)) continue;
-
-        for (const auto& entry : fs::recursive_directory_iterator(dir)) { // TODO: Добавить версию с fs::directory_iterator
-            if (entry.path().extension() == extension) {
-                files.push_back(entry.path().lexically_relative(StringUtils::toUtf8View(m_rootDirectory)).string());
-            }
-        }
-    }
-    return files;
-}
-
-std::vector<std::string> Resources::filesWithExtensionAsync(std::initializer_list<int> indices, std::string_view extension) const {
-    std::vector<std::future<std::vector<std::string>>> futures;
-    futures.reserve(indices.size());
-
-    // Запускаем асинхронные задачи для каждой директории
-    for (int index : indices) {
-        futures.push_back(std::async(std::launch::async, [this, index, extension]() {
-            auto dir = StringUtils::toUtf8View(m_mainDirectories[index]);
-            std::vector<std::string> localFiles;
-            if (!fs::is_directory(dir)) return localFiles;
-
-            for (const auto& entry : fs::recursive_directory_iterator(dir)) {
-                if (entry.path().extension() == extension) {
-                    localFiles.push_back(entry.path().lexically_relative(StringUtils::toUtf8View(m_rootDirectory)).string());
-                }
-            }
-            return localFiles;
-        }));
-    }
-
-    // Собираем результаты из всех потоков
-    std::vector<std::string> allFiles;
-    for (auto& future : futures) {
-        auto localFiles = future.get();
-        allFiles.insert(allFiles.end(), localFiles.begin(), localFiles.end());
-    }
-
-    return allFiles;
-}
@@ -3,8 +3,9 @@
 #include <string>
 #include <vector>
 #include <array>
-#include <map>
 
+#include "parsers/SDB_Parser.h"
+#include "FileIndex.h"
 #include "Types.h"
 
 class Resources
@@ -13,19 +14,13 @@ public:
     Resources(std::string_view rootDirectory);
 
     std::vector<std::string> levelNames(LevelType type) const;
-    std::vector<std::string> sdbFiles() const;
-    std::vector<std::string> csxFiles() const;
-    std::vector<std::string> mdfFiles() const;
-    std::vector<std::string> csFiles() const;
+    ResourceFiles files() const;
 
     StringHashTable<std::string> levelHumanNameDictionary() const;
-    std::map<int, std::string> dialogPhrases() const;
+    SDB_Strings dialogPhrases() const;
     StringHashTable<AgeVariable_t> globalVars() const;
 
 private:
-    std::vector<std::string> filesWithExtension(std::initializer_list<int> indices, std::string_view extension) const;
-    std::vector<std::string> filesWithExtensionAsync(std::initializer_list<int> indices, std::string_view extension) const;
-
     std::string_view m_rootDirectory;
     std::array<std::string, 15> m_mainDirectories;
 };
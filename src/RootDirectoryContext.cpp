@@ -5,8 +5,19 @@
 #include "utils/StringUtils.h"
 #include "utils/TracyProfiler.h"
 
+RootDirectoryContext::~RootDirectoryContext() {
+    // Фоновая загрузка публикует в члены этого объекта
+    if (m_loadPathFuture.valid()) {
+        m_loadPathFuture.wait();
+    }
+}
+
 void RootDirectoryContext::setRootDirectoryAndReload(std::string_view rootDirectory) {
+    if (m_loadPathFuture.valid()) {
+        m_loadPathFuture.wait();
+    }
     m_isLoading = true;
+    m_isLoadingAcquired = true;
 
     levels.clear(); // TODO: Что-то делать с уровнями если остались несохранённые данные
     selectedLevelIndex = 0;
@@ -16,52 +27,80 @@ void RootDirectoryContext::setRootDirectoryAndReload(std::string_view rootDirect
     showMdfWindow = false;
     showCsWindow = false;
 
-    asyncLoadResources(rootDirectory); // TODO: Запись rootDirectory в ini файл настроек
+    m_textureCache.clear();
+    resetResources();
+
+    m_rootDirectory = rootDirectory;
+    asyncLoadResources(); // TODO: Запись rootDirectory в ini файл настроек
 }
 
 bool RootDirectoryContext::isEmptyContext() const {
     bool emptyResources =
-            m_singleLevelNames.empty() &&
-            m_multiplayerLevelNames.empty() &&
-            m_csxFiles.empty() &&
-            m_sdbFiles.empty() &&
-            m_mdfFiles.empty() &&
-            m_csFiles.empty();
+            singleLevelNames().empty() &&
+            multiplayerLevelNames().empty() &&
+            csxFiles().empty() &&
+            sdbFiles().empty() &&
+            mdfFiles().empty() &&
+            csFiles().empty();
 
     return m_rootDirectory.empty() || emptyResources;
 }
 
-void RootDirectoryContext::asyncLoadResources(std::string_view rootDirectory) {
+bool RootDirectoryContext::acquireResources() {
+    // Флаг читается до снимков: если загрузка уже завершилась, все её публикации видны ниже
+    const bool isLoading = m_isLoading;
+    bool changed = isLoading != m_isLoadingAcquired;
+    m_isLoadingAcquired = isLoading;
+
+    changed |= m_singleLevelNames.acquire();
+    changed |= m_multiplayerLevelNames.acquire();
+    changed |= m_csxFiles.acquire();
+    changed |= m_sdbFiles.acquire();
+    changed |= m_mdfFiles.acquire();
+    changed |= m_csFiles.acquire();
+    changed |= m_levelHumanNamesDict.acquire();
+    changed |= m_dialogPhrases.acquire();
+    changed |= m_globalVars.acquire();
+    return changed;
+}
+
+void RootDirectoryContext::asyncLoadResources() {
     m_isLoading = true;
-    this->m_rootDirectory = rootDirectory;
-    auto backgroundTask = [] (RootDirectoryContext* context) {
-        Resources resources(context->rootDirectory());
-        {
-            Tracy_ZoneScopedN("ReadFiles");
-            context->m_singleLevelNames = resources.levelNames(LevelType::kSingle);
-            context->m_multiplayerLevelNames = resources.levelNames(LevelType::kMultiplayer);
-
-            context->m_csxFiles = resources.csxFiles();
-            context->m_sdbFiles = resources.sdbFiles();
-            context->m_mdfFiles = resources.mdfFiles();
-            context->m_csFiles = resources.csFiles();
-        }
-        {
+    auto backgroundTask = [this, rootDirectory = m_rootDirectory] () {
+        Resources resources(rootDirectory);
+        auto sorted = [] (std::vector<std::string> names) {
             Tracy_ZoneScopedN("NaturalSort");
-            std::sort(context->m_singleLevelNames.begin(), context->m_singleLevelNames.end(), StringUtils::naturalCompare);
-            std::sort(context->m_multiplayerLevelNames.begin(), context->m_multiplayerLevelNames.end(), StringUtils::naturalCompare);
+            std::sort(names.begin(), names.end(), StringUtils::naturalCompare);
+            return names;
+        };
+
+        // Сначала всё, что нужно LevelPicker: списки уровней и их имена
+        m_singleLevelNames.publish(sorted(resources.levelNames(LevelType::kSingle)));
+        m_multiplayerLevelNames.publish(sorted(resources.levelNames(LevelType::kMultiplayer)));
+        m_levelHumanNamesDict.publish(resources.levelHumanNameDictionary());
 
-            std::sort(context->m_csxFiles.begin(), context->m_csxFiles.end(), StringUtils::naturalCompare);
-            std::sort(context->m_sdbFiles.begin(), context->m_sdbFiles.end(), StringUtils::naturalCompare);
-            std::sort(context->m_mdfFiles.begin(), context->m_mdfFiles.end(), StringUtils::naturalCompare);
-            std::sort(context->m_csFiles.begin(), context->m_csFiles.end(), StringUtils::naturalCompare);
-        }
+        ResourceFiles files = resources.files();
+        m_csxFiles.publish(sorted(std::move(files.csxFiles)));
+        m_sdbFiles.publish(sorted(std::move(files.sdbFiles)));
+        m_mdfFiles.publish(sorted(std::move(files.mdfFiles)));
+        m_csFiles.publish(sorted(std::move(files.csFiles)));
 
-        context->m_levelHumanNamesDict = resources.levelHumanNameDictionary();
-        context->m_dialogPhrases = resources.dialogPhrases();
-        context->m_globalVars = resources.globalVars();
+        m_dialogPhrases.publish(resources.dialogPhrases());
+        m_globalVars.publish(resources.globalVars());
 
-        context->m_isLoading = false;
+        m_isLoading = false;
     };
-    m_loadPathFuture = std::async(std::launch::async, backgroundTask, this);
+    m_loadPathFuture = std::async(std::launch::async, std::move(backgroundTask));
+}
+
+void RootDirectoryContext::resetResources() {
+    m_singleLevelNames.reset();
+    m_multiplayerLevelNames.reset();
+    m_csxFiles.reset();
+    m_sdbFiles.reset();
+    m_mdfFiles.reset();
+    m_csFiles.reset();
+    m_levelHumanNamesDict.reset();
+    m_dialogPhrases.reset();
+    m_globalVars.reset();
 }
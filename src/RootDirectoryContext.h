@@ -4,28 +4,43 @@
 #include <future>
 #include <atomic>
 
+#include "graphics/TextureCache.h"
+#include "parsers/SDB_Parser.h"
+#include "utils/Snapshot.h"
 #include "Level.h"
 #include "Types.h"
 
+// Ресурсы корневого каталога. Списки загружаются в фоне по очереди, каждый публикуется, как только готов.
+// Поток UI забирает опубликованные списки в acquireResources() в начале кадра,
+// до следующего вызова ссылки из аксессоров не меняются
 class RootDirectoryContext {
 public:
+    ~RootDirectoryContext();
+
     void setRootDirectoryAndReload(std::string_view rootDirectory);
     bool isEmptyContext() const;
-    
+
+    // Поток UI, в начале кадра. true, если появились новые данные
+    bool acquireResources();
+
     std::string_view rootDirectory() const { return m_rootDirectory; }
-    bool isLoading() const { return m_isLoading; }
+    // Состояние на момент последнего acquireResources(): false только когда забраны все опубликованные списки
+    bool isLoading() const { return m_isLoadingAcquired; }
 
-    const auto& singleLevelNames() const { return m_singleLevelNames; }
-    const auto& multiplayerLevelNames() const { return m_multiplayerLevelNames; }
+    const auto& singleLevelNames() const { return m_singleLevelNames.get(); }
+    const auto& multiplayerLevelNames() const { return m_multiplayerLevelNames.get(); }
 
-    const auto& csxFiles() const { return m_csxFiles; }
-    const auto& sdbFiles() const { return m_sdbFiles; }
-    const auto& mdfFiles() const { return m_mdfFiles; }
-    const auto& csFiles() const { return m_csFiles; }
+    const auto& csxFiles() const { return m_csxFiles.get(); }
+    const auto& sdbFiles() const { return m_sdbFiles.get(); }
+    const auto& mdfFiles() const { return m_mdfFiles.get(); }
+    const auto& csFiles() const { return m_csFiles.get(); }
 
-    const auto& levelHumanNamesDict() const { return m_levelHumanNamesDict; }
-    const auto& dialogPhrases() const { return m_dialogPhrases; }
-    const auto& globalVars() const { return m_globalVars; }
+    const auto& levelHumanNamesDict() const { return m_levelHumanNamesDict.get(); }
+    const auto& dialogPhrases() const { return m_dialogPhrases.get(); }
+    const auto& globalVars() const { return m_globalVars.get(); }
+    auto sharedGlobalVars() const { return m_globalVars.share(); }
+
+    TextureCache& textureCache() { return m_textureCache; }
 
     std::vector<Level> levels;
     int selectedLevelIndex = 0;
@@ -36,21 +51,25 @@ public:
     bool showCsWindow = false;
 
 private:
-    void asyncLoadResources(std::string_view rootDirectory);
+    void asyncLoadResources();
+    void resetResources();
 
     std::string m_rootDirectory;
     std::future<void> m_loadPathFuture;
-    std::atomic<bool> m_isLoading{false};
+    std::atomic<bool> m_isLoading{false}; // Фоновая загрузка
+    bool m_isLoadingAcquired = false;
+
+    Snapshot<std::vector<std::string>> m_singleLevelNames;
+    Snapshot<std::vector<std::string>> m_multiplayerLevelNames;
 
-    std::vector<std::string> m_singleLevelNames;
-    std::vector<std::string> m_multiplayerLevelNames;
+    Snapshot<std::vector<std::string>> m_csxFiles;
+    Snapshot<std::vector<std::string>> m_sdbFiles;
+    Snapshot<std::vector<std::string>> m_mdfFiles;
+    Snapshot<std::vector<std::string>> m_csFiles;
 
-    std::vector<std::string> m_csxFiles;
-    std::vector<std::string> m_sdbFiles;
-    std::vector<std::string> m_mdfFiles;
-    std::vector<std::string> m_csFiles;
+    Snapshot<StringHashTable<std::string>> m_levelHumanNamesDict;
+    Snapshot<SDB_Strings> m_dialogPhrases;
+    Snapshot<StringHashTable<AgeVariable_t>> m_globalVars;
 
-    StringHashTable<std::string> m_levelHumanNamesDict;
-    std::map<int, std::string> m_dialogPhrases;
-    StringHashTable<AgeVariable_t> m_globalVars;
+    TextureCache m_textureCache;
 };
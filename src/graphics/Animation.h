@@ -2,14 +2,14 @@
 #include <cstdint>
 #include <vector>
 
-#include "Texture.h"
+#include "TextureAtlas.h"
 
 struct Animation {
-    std::vector<Texture> textures;
+    std::vector<TextureRegion> frames;  // Кадры в страницах атласа
     uint32_t delayMs = 0;
 
-    const Texture& currentTexture() const {
-        return textures[currentFrame];
+    const TextureRegion& currentRegion() const {
+        return frames[currentFrame];
     }
 
     void update(uint64_t timeMs/* = SDL_GetTicks()*/) {
@@ -24,6 +24,11 @@ struct Animation {
         }
     }
 
+    // Время смены кадра по тем же часам, что и update. 0, если update ещё не вызывался
+    uint64_t nextFrameTimeMs() const {
+        return lastUpdateTimeMs == 0 ? 0 : lastUpdateTimeMs + delayMs;
+    }
+
     void stop() {
         currentFrame = 0;
         lastUpdateTimeMs = 0;
@@ -32,7 +37,7 @@ struct Animation {
 protected:
     void nextFrame() {
         ++currentFrame;
-        if (currentFrame == textures.size()) {
+        if (currentFrame == frames.size()) {
             currentFrame = 0;
         }
     }
@@ -0,0 +1,350 @@
+#include "AssetCache.h"
+
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <bit>
+
+#include <SDL3/SDL_iostream.h>
+
+#include "utils/TracyProfiler.h"
+#include "utils/StringUtils.h"
+#include "utils/FileUtils.h"
+#include "utils/DebugLog.h"
+
+namespace {
+
+constexpr uint32_t kMagic = 0x43414C47; // "GLAC"
+constexpr uint32_t kVersion = 1;
+
+enum class EntryKind : uint32_t {
+    kIndexedImage = 1,
+    kSurface = 2
+};
+
+// Заголовок файла кэша. За ним следует путь к исходному файлу (для проверки коллизий) и пиксели
+struct EntryHeader {
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    EntryKind kind = EntryKind::kIndexedImage;
+    uint32_t format = 0; // SDL_PixelFormat для kSurface
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    uint64_t sourceHash = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t frameHeight = 0;
+    uint32_t pathSize = 0;
+};
+static_assert(sizeof(EntryHeader) == 56, "EntryHeader layout is part of the file format");
+
+std::atomic<bool> g_isEnabled{true};
+
+std::mutex g_trimMutex;
+std::atomic<int64_t> g_totalSize{-1}; // Оценка размера каталога, -1 - ещё не подсчитан
+
+uint64_t hashBytes(std::span<const uint8_t> data)
+{
+    Tracy_ZoneScoped;
+    constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+
+    uint64_t hash = kPrime1 ^ data.size();
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= data.size(); i += sizeof(uint64_t)) {
+        uint64_t value;
+        std::memcpy(&value, data.data() + i, sizeof(value));
+        hash = std::rotl(hash ^ (value * kPrime2), 31) * kPrime1;
+    }
+    for (; i < data.size(); ++i) {
+        hash = std::rotl(hash ^ (data[i] * kPrime2), 11) * kPrime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+bool sourceFileInfo(std::string_view sourcePath, uint64_t& outSize, int64_t& outMtime)
+{
+    std::error_code ec;
+    std::filesystem::path path(StringUtils::toUtf8View(sourcePath));
+    outSize = std::filesystem::file_size(path, ec);
+    if (ec)
+        return false;
+
+    outMtime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+    return !ec;
+}
+
+std::string entryPath(std::string_view sourcePath)
+{
+    return std::format("{}/{:016x}.bin", AssetCache::kEntriesDirectory,
+                       hashBytes({(const uint8_t*)sourcePath.data(), sourcePath.size()}));
+}
+
+// Время изменения записи служит временем последнего чтения для вытеснения
+void touchEntry(const std::string& path)
+{
+    std::error_code ec;
+    std::filesystem::last_write_time(StringUtils::toUtf8View(path), std::filesystem::file_time_type::clock::now(), ec);
+}
+
+// Учитывает addedBytes и, если размер kEntriesDirectory превысил kMaxTotalSize, удаляет самые старые записи до 3/4 лимита.
+// Каталог сканируется при первой записи и при превышении, в остальное время размер только оценивается
+void trimCache(int64_t addedBytes)
+{
+    int64_t totalSize = g_totalSize.load();
+    if (totalSize >= 0) {
+        totalSize = g_totalSize.fetch_add(addedBytes) + addedBytes;
+        if (totalSize <= (int64_t)AssetCache::kMaxTotalSize)
+            return;
+    }
+
+    Tracy_ZoneScoped;
+    std::lock_guard lock(g_trimMutex);
+
+    struct Entry {
+        std::filesystem::path path;
+        uint64_t size = 0;
+        std::filesystem::file_time_type time;
+    };
+    std::vector<Entry> entries;
+    totalSize = 0;
+
+    std::error_code ec;
+    for (const auto& dirEntry : std::filesystem::directory_iterator(StringUtils::toUtf8View(AssetCache::kEntriesDirectory), ec)) {
+        std::error_code entryEc;
+        if (!dirEntry.is_regular_file(entryEc) || dirEntry.path().extension() != ".bin")
+            continue;
+
+        Entry entry;
+        entry.path = dirEntry.path();
+        entry.size = dirEntry.file_size(entryEc);
+        entry.time = dirEntry.last_write_time(entryEc);
+        if (entryEc)
+            continue;
+
+        totalSize += entry.size;
+        entries.push_back(std::move(entry));
+    }
+
+    if (totalSize > (int64_t)AssetCache::kMaxTotalSize) {
+        std::sort(entries.begin(), entries.end(), [] (const Entry& left, const Entry& right) {
+            return left.time < right.time;
+        });
+
+        const int64_t targetSize = AssetCache::kMaxTotalSize / 4 * 3;
+        size_t removedCount = 0;
+        for (const Entry& entry : entries) {
+            if (totalSize <= targetSize)
+                break;
+            // Запись, открытая другим потоком, может не удалиться. Она останется до следующего раза
+            if (std::filesystem::remove(entry.path, ec)) {
+                totalSize -= entry.size;
+                ++removedCount;
+            }
+        }
+        LogFmt("AssetCache: {} entries evicted, {} MB left", removedCount, totalSize >> 20);
+    }
+    g_totalSize = totalSize;
+}
+
+// Проверяет запись и возвращает её пиксели. outEntryFile держит отображение, пока payload используется
+bool readEntry(std::string_view sourcePath, EntryKind kind, MappedFile& outEntryFile, EntryHeader& outHeader, std::span<const uint8_t>& outPayload)
+{
+    Tracy_ZoneScoped;
+    if (!g_isEnabled)
+        return false;
+
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!sourceFileInfo(sourcePath, sourceSize, sourceMtime))
+        return false;
+
+    const std::string path = entryPath(sourcePath);
+    outEntryFile = FileUtils::mapFile(path);
+    std::span<const uint8_t> entryData = outEntryFile.data();
+    if (entryData.size() < sizeof(EntryHeader))
+        return false;
+
+    std::memcpy(&outHeader, entryData.data(), sizeof(EntryHeader));
+    if (outHeader.magic != kMagic || outHeader.version != kVersion || outHeader.kind != kind)
+        return false;
+
+    if (entryData.size() < sizeof(EntryHeader) + outHeader.pathSize)
+        return false;
+
+    std::string_view storedPath((const char*)entryData.data() + sizeof(EntryHeader), outHeader.pathSize);
+    if (storedPath != sourcePath || outHeader.sourceSize != sourceSize)
+        return false;
+
+    if (outHeader.sourceMtime != sourceMtime) {
+        // Время изменения другое, сверяем содержимое
+        MappedFile sourceFile = FileUtils::mapFile(sourcePath);
+        if (!sourceFile || hashBytes(sourceFile.data()) != outHeader.sourceHash)
+            return false;
+
+        outHeader.sourceMtime = sourceMtime;
+        if (SDL_IOStream* stream = SDL_IOFromFile(path.c_str(), "r+b")) {
+            SDL_WriteIO(stream, &outHeader, sizeof(EntryHeader));
+            SDL_CloseIO(stream);
+        }
+    }
+
+    touchEntry(path);
+    outPayload = entryData.subspan(sizeof(EntryHeader) + outHeader.pathSize);
+    return true;
+}
+
+// Запись во временный файл и переименование: параллельные загрузчики не увидят недописанный файл
+void writeEntry(std::string_view sourcePath, std::span<const uint8_t> sourceData, EntryHeader header, std::span<const std::span<const uint8_t>> payload)
+{
+    Tracy_ZoneScoped;
+    if (!g_isEnabled)
+        return;
+
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!sourceFileInfo(sourcePath, sourceSize, sourceMtime) || sourceSize != sourceData.size())
+        return;
+
+    header.sourceSize = sourceSize;
+    header.sourceMtime = sourceMtime;
+    header.sourceHash = hashBytes(sourceData);
+    header.pathSize = (uint32_t)sourcePath.size();
+
+    size_t blobSize = sizeof(EntryHeader) + sourcePath.size();
+    for (std::span<const uint8_t> chunk : payload) {
+        blobSize += chunk.size();
+    }
+
+    std::vector<uint8_t> blob;
+    blob.reserve(blobSize);
+    blob.insert(blob.end(), (const uint8_t*)&header, (const uint8_t*)&header + sizeof(EntryHeader));
+    blob.insert(blob.end(), sourcePath.begin(), sourcePath.end());
+    for (std::span<const uint8_t> chunk : payload) {
+        blob.insert(blob.end(), chunk.begin(), chunk.end());
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(StringUtils::toUtf8View(AssetCache::kEntriesDirectory), ec);
+
+    const std::string path = entryPath(sourcePath);
+    const std::string tempPath = std::format("{}.{}.tmp", path, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    std::string error;
+    if (!FileUtils::saveFile(tempPath, blob, &error)) {
+        LogFmt("AssetCache: write {} failed. {}", tempPath, error);
+        return;
+    }
+
+    std::filesystem::rename(StringUtils::toUtf8View(tempPath), StringUtils::toUtf8View(path), ec);
+    if (ec) {
+        LogFmt("AssetCache: rename {} failed. {}", tempPath, ec.message());
+        std::filesystem::remove(StringUtils::toUtf8View(tempPath), ec);
+        return;
+    }
+
+    trimCache((int64_t)blob.size());
+}
+
+} // namespace
+
+void AssetCache::setEnabled(bool enabled)
+{
+    g_isEnabled = enabled;
+}
+
+bool AssetCache::isEnabled()
+{
+    return g_isEnabled;
+}
+
+bool AssetCache::loadIndexedImage(std::string_view sourcePath, IndexedImage& outImage)
+{
+    Tracy_ZoneScoped;
+    MappedFile entryFile;
+    EntryHeader header;
+    std::span<const uint8_t> payload;
+    if (!readEntry(sourcePath, EntryKind::kIndexedImage, entryFile, header, payload))
+        return false;
+
+    const size_t paletteSize = sizeof(outImage.palette);
+    const size_t pixelsSize = (size_t)header.width * header.height;
+    if (header.width <= 0 || header.height <= 0 || header.frameHeight <= 0 || payload.size() != paletteSize + pixelsSize)
+        return false;
+
+    outImage.width = header.width;
+    outImage.height = header.height;
+    outImage.frameHeight = header.frameHeight;
+    std::memcpy(outImage.palette.data(), payload.data(), paletteSize);
+    outImage.pixels.assign(payload.begin() + paletteSize, payload.end());
+    return true;
+}
+
+void AssetCache::storeIndexedImage(std::string_view sourcePath, std::span<const uint8_t> sourceData, const IndexedImage& image)
+{
+    Tracy_ZoneScoped;
+    EntryHeader header;
+    header.kind = EntryKind::kIndexedImage;
+    header.width = image.width;
+    header.height = image.height;
+    header.frameHeight = image.frameHeight;
+
+    const std::span<const uint8_t> payload[] = {
+        {(const uint8_t*)image.palette.data(), sizeof(image.palette)},
+        image.pixels
+    };
+    writeEntry(sourcePath, sourceData, header, payload);
+}
+
+SurfacePtr AssetCache::loadSurface(std::string_view sourcePath, SDL_PixelFormat format)
+{
+    Tracy_ZoneScoped;
+    MappedFile entryFile;
+    EntryHeader header;
+    std::span<const uint8_t> payload;
+    if (!readEntry(sourcePath, EntryKind::kSurface, entryFile, header, payload))
+        return {};
+
+    const size_t lineSize = (size_t)header.width * SDL_BYTESPERPIXEL(format);
+    if (header.format != (uint32_t)format || header.width <= 0 || header.height <= 0 || payload.size() != lineSize * header.height)
+        return {};
+
+    SurfacePtr surface(SDL_CreateSurface(header.width, header.height, format));
+    if (!surface)
+        return {};
+
+    for (int y = 0; y < header.height; ++y) {
+        std::memcpy((uint8_t*)surface->pixels + (size_t)y * surface->pitch, payload.data() + y * lineSize, lineSize);
+    }
+    return surface;
+}
+
+void AssetCache::storeSurface(std::string_view sourcePath, std::span<const uint8_t> sourceData, const SDL_Surface* surface)
+{
+    Tracy_ZoneScoped;
+    EntryHeader header;
+    header.kind = EntryKind::kSurface;
+    header.format = (uint32_t)surface->format;
+    header.width = surface->w;
+    header.height = surface->h;
+    header.frameHeight = surface->h;
+
+    // Строки без выравнивания pitch
+    const size_t lineSize = (size_t)surface->w * SDL_BYTESPERPIXEL(surface->format);
+    if (lineSize * surface->h > kMaxSurfaceSize)
+        return;
+
+    std::vector<std::span<const uint8_t>> lines;
+    lines.reserve(surface->h);
+    for (int y = 0; y < surface->h; ++y) {
+        lines.push_back({(const uint8_t*)surface->pixels + (size_t)y * surface->pitch, lineSize});
+    }
+    writeEntry(sourcePath, sourceData, header, lines);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <string_view>
+#include <cstdint>
+#include <span>
+
+#include "IndexedImage.h"
+#include "Surface.h"
+
+// Дисковый кэш декодированных изображений (каталог рядом с settings.ini).
+// Пиксели хранятся без сжатия, загрузка из кэша - одно последовательное чтение вместо декодирования JPEG/CSX.
+// Запись действительна, пока у исходного файла совпадают размер и время изменения.
+// Если время изменилось, а хэш содержимого совпал (файлы скопированы заново), запись обновляется и используется.
+// Общий размер ограничен kMaxTotalSize: при превышении удаляются записи, которые дольше всех не читались.
+// Все функции потокобезопасны
+class AssetCache
+{
+public:
+    AssetCache() = delete;
+
+    static constexpr std::string_view kDirectory = "cache";
+    // Записи лежат в своём подкаталоге: в kDirectory есть и другие файлы (манифесты FileIndex),
+    // которые не учитываются в kMaxTotalSize и не вытесняются
+    static constexpr std::string_view kEntriesDirectory = "cache/assets";
+    static constexpr uint64_t kMaxTotalSize = 512ull << 20;
+    // Большие изображения (фоны уровней в JPEG) без сжатия занимают десятки МБ,
+    // их чтение с диска не быстрее декодирования, поэтому они не кэшируются
+    static constexpr uint64_t kMaxSurfaceSize = 8ull << 20;
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    static bool loadIndexedImage(std::string_view sourcePath, IndexedImage& outImage);
+    static void storeIndexedImage(std::string_view sourcePath, std::span<const uint8_t> sourceData, const IndexedImage& image);
+
+    static SurfacePtr loadSurface(std::string_view sourcePath, SDL_PixelFormat format);
+    static void storeSurface(std::string_view sourcePath, std::span<const uint8_t> sourceData, const SDL_Surface* surface);
+};
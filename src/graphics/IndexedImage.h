@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <array>
+
+// 8-битное изображение с палитрой, разбитое по высоте на кадры (последний кадр может быть короче).
+// Декодируется без SDL_Surface и рендерера, палитра одна на весь файл
+struct IndexedImage {
+    static constexpr int kMaxColors = 256;
+
+    int width = 0;
+    int height = 0;
+    int frameHeight = 0;
+    std::vector<uint8_t> pixels;                  // Индексы палитры, pitch == width
+    std::array<uint32_t, kMaxColors> palette = {}; // Порядок байт SDL_PIXELFORMAT_RGBA32
+
+    bool isValid() const { return width > 0 && height > 0 && frameHeight > 0; }
+
+    int frameCount() const {
+        return isValid() ? (height + frameHeight - 1) / frameHeight : 0;
+    }
+
+    int frameLineCount(int frameIndex) const {
+        int lineIndexStart = frameIndex * frameHeight;
+        return (lineIndexStart + frameHeight <= height) ? frameHeight : height - lineIndexStart;
+    }
+};
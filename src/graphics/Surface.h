@@ -0,0 +1,13 @@
+#pragma once
+#include <memory>
+
+#include "SDL3/SDL_surface.h"
+
+struct SurfaceDeleter {
+    void operator()(SDL_Surface* surface) const noexcept {
+        SDL_DestroySurface(surface);
+    }
+};
+
+// Владеющий указатель на SDL_Surface. В отличие от SDL_Texture поверхности можно создавать в любом потоке
+using SurfacePtr = std::unique_ptr<SDL_Surface, SurfaceDeleter>;
@@ -33,6 +33,10 @@ public:
 
     SDL_Texture* get() const noexcept { return m_texture; }
 
+    size_t byteSize() const noexcept {
+        return m_texture ? (size_t)m_texture->w * m_texture->h * SDL_BYTESPERPIXEL(m_texture->format) : 0;
+    }
+
     const SDL_Texture* operator->() const noexcept { return m_texture; }
 
 private:
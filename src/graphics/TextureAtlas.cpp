@@ -0,0 +1,190 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+#include "utils/TracyProfiler.h"
+#include "utils/DebugLog.h"
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+namespace {
+
+struct FramePlacement {
+    int imageIndex = 0;
+    int frameIndex = 0;
+    int page = -1;
+    int x = 0;
+    int y = 0;
+    int w = 0; // С учётом padding
+    int h = 0;
+    int padding = TextureAtlas::kPadding;
+};
+
+// Раскрывает кадр через палитру, дублируя крайние строки и столбцы в рамку шириной padding.
+// Если размер в текстуре (без рамки) меньше размера кадра, кадр уменьшается выборкой ближайшего пикселя
+void expandFrame(const IndexedImage& image, int frameIndex, const FramePlacement& placement, std::vector<uint32_t>& outPixels)
+{
+    const int p = placement.padding;
+    const int width = image.width;
+    const int lineCount = image.frameLineCount(frameIndex);
+    const int dstWidth = placement.w - 2 * p;
+    const int dstHeight = placement.h - 2 * p;
+    outPixels.resize((size_t)placement.w * placement.h);
+
+    std::vector<int> srcX(dstWidth);
+    for (int x = 0; x < dstWidth; ++x) {
+        srcX[x] = (int)((int64_t)x * width / dstWidth);
+    }
+
+    const uint8_t* indexes = image.pixels.data() + (size_t)frameIndex * image.frameHeight * width;
+    for (int y = -p; y < dstHeight + p; ++y) {
+        const int sourceY = (int)((int64_t)std::clamp(y, 0, dstHeight - 1) * lineCount / dstHeight);
+        const uint8_t* srcLine = indexes + (size_t)sourceY * width;
+        uint32_t* dstLine = outPixels.data() + (size_t)(y + p) * placement.w;
+        for (int x = 0; x < p; ++x) {
+            dstLine[x] = image.palette[srcLine[0]];
+            dstLine[p + dstWidth + x] = image.palette[srcLine[width - 1]];
+        }
+        for (int x = 0; x < dstWidth; ++x) {
+            dstLine[p + x] = image.palette[srcLine[srcX[x]]];
+        }
+    }
+}
+
+} // namespace
+
+bool TextureAtlas::build(SDL_Renderer* renderer,
+                         std::span<const IndexedImage* const> images,
+                         SDL_BlendMode blendMode,
+                         std::vector<std::vector<TextureRegion>>& outRegions,
+                         std::string* error)
+{
+    Tracy_ZoneScoped;
+
+    SDL_PropertiesID props = SDL_GetRendererProperties(renderer);
+    int maxTextureSize = (int)SDL_GetNumberProperty(props, SDL_PROP_RENDERER_MAX_TEXTURE_SIZE_NUMBER, 0);
+    const int pageSize = (maxTextureSize > 0) ? std::min(maxTextureSize, kMaxPageSize) : kMaxPageSize;
+    if (maxTextureSize <= 0) {
+        maxTextureSize = INT_MAX;
+    }
+
+    std::vector<FramePlacement> placements;
+    for (int i = 0; i < (int)images.size(); ++i) {
+        const IndexedImage& image = *images[i];
+        for (int frame = 0; frame < image.frameCount(); ++frame) {
+            placements.push_back({i, frame, -1, 0, 0,
+                                  image.width + 2 * kPadding,
+                                  image.frameLineCount(frame) + 2 * kPadding});
+        }
+    }
+
+    // Размеры страниц по фактически занятой области
+    std::vector<SDL_Point> pageSizes;
+
+    std::vector<stbrp_rect> pending;
+    for (int i = 0; i < (int)placements.size(); ++i) {
+        FramePlacement& placement = placements[i];
+        if (placement.w > pageSize || placement.h > pageSize) {
+            // Отдельная страница. Без рамки, если с ней не помещается в текстуру,
+            // и с уменьшением, если в текстуру не помещается и сам кадр
+            if (placement.w > maxTextureSize || placement.h > maxTextureSize) {
+                const int frameWidth = placement.w - 2 * placement.padding;
+                const int frameHeight = placement.h - 2 * placement.padding;
+                placement.padding = 0;
+                placement.w = frameWidth;
+                placement.h = frameHeight;
+                if (frameWidth > maxTextureSize || frameHeight > maxTextureSize) {
+                    const double scale = std::min((double)maxTextureSize / frameWidth, (double)maxTextureSize / frameHeight);
+                    placement.w = std::clamp((int)(frameWidth * scale), 1, maxTextureSize);
+                    placement.h = std::clamp((int)(frameHeight * scale), 1, maxTextureSize);
+                    LogFmt("Texture atlas: frame {}x{} scaled to {}x{}", frameWidth, frameHeight, placement.w, placement.h);
+                }
+            }
+            placement.page = (int)pageSizes.size();
+            pageSizes.push_back({placement.w, placement.h});
+            continue;
+        }
+        stbrp_rect rect = {};
+        rect.id = i;
+        rect.w = placement.w;
+        rect.h = placement.h;
+        pending.push_back(rect);
+    }
+
+    std::vector<stbrp_node> nodes(pageSize);
+    while (!pending.empty()) {
+        stbrp_context context;
+        stbrp_init_target(&context, pageSize, pageSize, nodes.data(), (int)nodes.size());
+        stbrp_pack_rects(&context, pending.data(), (int)pending.size());
+
+        const int page = (int)pageSizes.size();
+        SDL_Point usedSize = {0, 0};
+        auto packedEnd = std::stable_partition(pending.begin(), pending.end(), [] (const stbrp_rect& rect) {
+            return !rect.was_packed;
+        });
+        for (auto it = packedEnd; it != pending.end(); ++it) {
+            FramePlacement& placement = placements[it->id];
+            placement.page = page;
+            placement.x = it->x;
+            placement.y = it->y;
+            usedSize.x = std::max(usedSize.x, it->x + it->w);
+            usedSize.y = std::max(usedSize.y, it->y + it->h);
+        }
+        if (packedEnd == pending.end()) {
+            if (error)
+                *error = "Texture atlas packing failed";
+            return false;
+        }
+        pageSizes.push_back(usedSize);
+        pending.erase(packedEnd, pending.end());
+    }
+
+    std::vector<Texture> pages;
+    pages.reserve(pageSizes.size());
+    for (const SDL_Point& size : pageSizes) {
+        Texture page = Texture::create(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, size.x, size.y, error);
+        if (!page)
+            return false;
+        SDL_SetTextureBlendMode(page.get(), blendMode);
+        pages.push_back(std::move(page));
+    }
+
+    outRegions.clear();
+    outRegions.resize(images.size());
+    for (int i = 0; i < (int)images.size(); ++i) {
+        outRegions[i].resize(images[i]->frameCount());
+    }
+
+    std::vector<uint32_t> stagingBuffer;
+    for (const FramePlacement& placement : placements) {
+        assert(placement.page >= 0);
+        const IndexedImage& image = *images[placement.imageIndex];
+        expandFrame(image, placement.frameIndex, placement, stagingBuffer);
+
+        Texture& page = pages[placement.page];
+        SDL_Rect rect(placement.x, placement.y, placement.w, placement.h);
+        if (!page.updatePixels(stagingBuffer.data(), &rect, error))
+            return false;
+
+        const float pageWidth = (float)pageSizes[placement.page].x;
+        const float pageHeight = (float)pageSizes[placement.page].y;
+        TextureRegion& region = outRegions[placement.imageIndex][placement.frameIndex];
+        region.texture = page.get();
+        // Размер отрисовки - исходный размер кадра, даже если в текстуре он уменьшен
+        const int p = placement.padding;
+        region.w = image.width;
+        region.h = image.frameLineCount(placement.frameIndex);
+        region.u0 = (placement.x + p) / pageWidth;
+        region.v0 = (placement.y + p) / pageHeight;
+        region.u1 = (placement.x + placement.w - p) / pageWidth;
+        region.v1 = (placement.y + placement.h - p) / pageHeight;
+    }
+
+    LogFmt("Texture atlas: {} frames in {} pages", placements.size(), pages.size());
+    m_pages = std::move(pages);
+    return true;
+}
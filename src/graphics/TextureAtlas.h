@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <span>
+
+#include "SDL3/SDL_render.h"
+
+#include "IndexedImage.h"
+#include "Texture.h"
+
+// Прямоугольник внутри страницы атласа
+struct TextureRegion {
+    SDL_Texture* texture = nullptr;
+    int w = 0;
+    int h = 0;
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 1.0f;
+    float v1 = 1.0f;
+};
+
+// Набор больших текстур (страниц), в которые упакованы кадры многих изображений.
+// Все изображения одной страницы рисуются без смены текстуры, что позволяет ImGui объединять их в один draw call
+class TextureAtlas
+{
+public:
+    static constexpr int kMaxPageSize = 4096;
+    static constexpr int kPadding = 1; // Повтор крайних пикселей кадра, исключает захват соседей при фильтрации
+
+    TextureAtlas() noexcept = default;
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    TextureAtlas(TextureAtlas&& other) noexcept = default;
+    TextureAtlas& operator=(TextureAtlas&& other) noexcept = default;
+
+    // Упаковывает все кадры images. outRegions[i][frame] - область кадра изображения images[i].
+    // Кадр, не помещающийся в страницу, получает собственную страницу. Кадр больше
+    // SDL_PROP_RENDERER_MAX_TEXTURE_SIZE_NUMBER хранится уменьшенным, но рисуется в исходном размере
+    bool build(SDL_Renderer* renderer,
+               std::span<const IndexedImage* const> images,
+               SDL_BlendMode blendMode,
+               std::vector<std::vector<TextureRegion>>& outRegions,
+               std::string* error = nullptr);
+
+    const std::vector<Texture>& pages() const { return m_pages; }
+
+    void clear() noexcept { m_pages.clear(); }
+
+private:
+    std::vector<Texture> m_pages;
+};
@@ -0,0 +1,62 @@
+#include "TextureCache.h"
+
+#include <algorithm>
+
+void TextureCache::clear() noexcept
+{
+    m_retained.clear();
+    m_entries.clear();
+    m_stats.entryCount = 0;
+}
+
+size_t TextureCache::residentBytes() const noexcept
+{
+    size_t result = 0;
+    for (const auto& [key, entry] : m_entries) {
+        if (TextureHandle handle = entry.lock()) {
+            result += CacheSizeOf<TextureSet>()(*handle);
+        }
+    }
+    return result;
+}
+
+std::string TextureCache::normalizePath(std::string_view path)
+{
+    std::string result;
+    result.reserve(path.size());
+    for (char c : path) {
+        if (c == '\\')
+            c = '/';
+        if (c == '/' && !result.empty() && result.back() == '/')
+            continue;
+        result.push_back(c);
+    }
+    return result;
+}
+
+std::string TextureCache::makeKey(std::string_view assetPath, std::string_view variant)
+{
+    std::string key = normalizePath(assetPath);
+    if (!variant.empty()) {
+        key += '|';
+        key += variant;
+    }
+    return key;
+}
+
+void TextureCache::retain(std::string_view key, const TextureHandle& handle)
+{
+    // Вытеснение из m_retained только снимает ссылку кэша, handle у окон остаются действительными
+    m_retained.load(key, [&handle]() -> std::optional<TextureHandle> {
+        return handle;
+    });
+    m_retained.trim();
+}
+
+void TextureCache::removeExpired() noexcept
+{
+    m_stats.evictions += std::erase_if(m_entries, [] (const auto& entry) {
+        return entry.second.expired();
+    });
+    m_stats.entryCount = m_entries.size();
+}
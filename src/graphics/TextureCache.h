@@ -0,0 +1,73 @@
+#pragma once
+#include <string_view>
+#include <optional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Texture.h"
+#include "Cache.h"
+#include "Types.h"
+
+using TextureSet = std::vector<Texture>;
+using TextureHandle = std::shared_ptr<const TextureSet>;
+
+// Общий для всех окон кэш текстур, принадлежит RootDirectoryContext.
+// Текстуры живут, пока существует хотя бы один TextureHandle. Ресурс, который уже показан в другом окне,
+// не декодируется и не загружается в видеопамять заново.
+// Кроме того, кэш сам удерживает недавно использованные ресурсы в пределах kRetainedBytes (LRU).
+// Только из потока рендера
+class TextureCache
+{
+public:
+    static constexpr size_t kRetainedBytes = 64 * 1024 * 1024;
+
+    TextureCache() noexcept = default;
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // variant различает разные способы загрузки одного файла (разбиение на кадры, прозрачный цвет)
+    template <LoadCallback<TextureSet> Callback>
+    TextureHandle load(std::string_view assetPath, std::string_view variant, Callback&& callback) {
+        Tracy_ZoneScoped;
+        std::string key = makeKey(assetPath, variant);
+        if (auto it = m_entries.find(key); it != m_entries.end()) {
+            if (TextureHandle handle = it->second.lock()) {
+                ++m_stats.hits;
+                retain(key, handle);
+                return handle;
+            }
+        }
+
+        ++m_stats.misses;
+        std::optional<TextureSet> textures = std::forward<Callback>(callback)();
+        if (!textures)
+            return {};
+
+        removeExpired();
+        TextureHandle handle = std::make_shared<const TextureSet>(std::move(*textures));
+        m_entries.insert_or_assign(key, handle);
+        retain(key, handle);
+        return handle;
+    }
+
+    // Забывает все записи. Текстуры, на которые ещё есть TextureHandle, освобождаются вместе с последним из них
+    void clear() noexcept;
+
+    // Объём текстур, на которые есть хотя бы один TextureHandle
+    size_t residentBytes() const noexcept;
+    const CacheStats& stats() const noexcept { return m_stats; }
+
+    // Разделители пути приводятся к '/'. Регистр сохраняется: пути на Linux различаются регистром
+    static std::string normalizePath(std::string_view path);
+
+private:
+    static std::string makeKey(std::string_view assetPath, std::string_view variant);
+    void removeExpired() noexcept;
+    void retain(std::string_view key, const TextureHandle& handle);
+
+    StringHashTable<std::weak_ptr<const TextureSet>> m_entries;
+    CacheStats m_stats;
+    Cache<TextureHandle> m_retained{kRetainedBytes, "Shared texture cache"};
+};
@@ -1,10 +1,13 @@
 #include "TextureLoader.h"
 
+#include <algorithm>
+#include <cassert>
 #include <memory>
 
 #include "stb_image.h"
 
 #include "parsers/CSX_Parser.h"
+#include "AssetCache.h"
 #include "Texture.h"
 
 #include "utils/TracyProfiler.h"
@@ -15,76 +18,23 @@
 bool TextureLoader::loadTextureFromFile(std::string_view fileName, SDL_Renderer* renderer, Texture& outTexture, std::string* error)
 {
     Tracy_ZoneScoped;
-    std::vector<uint8_t> fileData = FileUtils::loadFile(fileName, error);
-    if (fileData.empty())
+    MappedFile fileData = FileUtils::mapFile(fileName, error);
+    if (!fileData)
         return false;
 
-    return loadTextureFromMemory(fileData, renderer, outTexture, error);
+    return loadTextureFromMemory(fileData.data(), renderer, outTexture, error);
 }
 
 bool TextureLoader::loadTextureFromMemory(std::span<const uint8_t> memory, SDL_Renderer* renderer, Texture& outTexture, std::string* error)
 {
     Tracy_ZoneScoped;
-    bool have16BitSupport = false;
-    SDL_PropertiesID props = SDL_GetRendererProperties(renderer);
-    const SDL_PixelFormat* formats = (const SDL_PixelFormat*)SDL_GetPointerProperty(props, SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER, NULL);
-    if (formats) {
-        int i = 0;
-        while (formats[i] != SDL_PIXELFORMAT_UNKNOWN) {
-            if (formats[i] == SDL_PIXELFORMAT_RGB565) {
-                have16BitSupport = true;
-                break;
-            }
-            ++i;
-        }
-    }
-
-    int imageWidth = 0;
-    int imageHeight = 0;
-    int channels = have16BitSupport ? 3 : 4;
-    Tracy_ZoneStartN("stbImageLoad");
-    std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> imageDataPtr = {
-        stbi_load_from_memory((const stbi_uc*)memory.data(), (int)memory.size(), &imageWidth, &imageHeight, NULL, channels),
-        stbi_image_free
-    };
-    Tracy_ZoneEnd();
-
-    if (!imageDataPtr) {
-        if (error)
-            *error = std::string(stbi_failure_reason());
+    SurfacePtr surface = decodeImageFromMemory(memory, have16BitSupport(renderer), error);
+    if (!surface)
         return false;
-    }
 
-    Texture texture = Texture::create(renderer,
-                                      have16BitSupport ? SDL_PIXELFORMAT_RGB565
-                                                       : SDL_PIXELFORMAT_RGBA32,
-                                      SDL_TEXTUREACCESS_STATIC,
-                                      imageWidth,
-                                      imageHeight,
-                                      error);
-    if (!texture) {
+    Texture texture = Texture::createFromSurface(renderer, surface.get(), error);
+    if (!texture)
         return false;
-    }
-
-    {
-        if (have16BitSupport) {
-            Tracy_ZoneScopedN("convertPixels");
-            const int srcPitch = 3 * imageWidth;
-            const int dstPitch = 2 * imageWidth;
-            bool isOk = SDL_ConvertPixels(imageWidth, imageHeight,
-                                          SDL_PIXELFORMAT_RGB24, imageDataPtr.get(), srcPitch,
-                                          SDL_PIXELFORMAT_RGB565, imageDataPtr.get(), dstPitch);
-            if (!isOk) {
-                if (error)
-                    *error = std::string(SDL_GetError());
-                return false;
-            }
-        }
-
-        if (!texture.updatePixels(imageDataPtr.get(), nullptr, error)) {
-            return false;
-        }
-    }
 
     outTexture = std::move(texture);
     return true;
@@ -93,27 +43,15 @@ bool TextureLoader::loadTextureFromMemory(std::span<const uint8_t> memory, SDL_R
 bool TextureLoader::loadTextureFromCsxFile(std::string_view fileName, SDL_Renderer* renderer, Texture& outTexture, std::string* error)
 {
     Tracy_ZoneScoped;
-    std::vector<uint8_t> fileData = FileUtils::loadFile(fileName, error);
-    if (fileData.empty())
-        return false;
-
-    CSX_Parser csxParser(fileData);
-    std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surfacePtr = {
-        csxParser.parse(false, error),
-        SDL_DestroySurface
-    };
-
-    if (!surfacePtr)
+    IndexedImage image;
+    if (!decodeCsxFile(fileName, image, error))
         return false;
 
-    Texture texture = Texture::createFromSurface(renderer, surfacePtr.get(), error);
+    Texture texture = createTextureFromIndexedFrame(image, 0, renderer, error);
     if (!texture)
         return false;
 
-    //SDL_SetTexturePalette(texture.get(), csxParser.metaInfo().pallete);
-    SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_BLEND);
     outTexture = std::move(texture);
-
     return true;
 }
 
@@ -130,20 +68,16 @@ bool TextureLoader::saveCsxAsBmpFile(std::string_view fileNameCsx, std::string_v
 {
     Tracy_ZoneScoped;
 
-    std::vector<uint8_t> fileData = FileUtils::loadFile(fileNameCsx, error);
-    if (fileData.empty())
+    MappedFile fileData = FileUtils::mapFile(fileNameCsx, error);
+    if (!fileData)
         return false;
 
-    CSX_Parser csxParser(fileData);
-    std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surfacePtr = {
-        csxParser.parse(false, error),
-        SDL_DestroySurface
-    };
-
-    if (!surfacePtr)
+    CSX_Parser csxParser(fileData.data());
+    SurfacePtr surface(csxParser.parse(false, error));
+    if (!surface)
         return false;
 
-    bool isOk = SDL_SaveBMP(surfacePtr.get(), fileNameBmp.data());
+    bool isOk = SDL_SaveBMP(surface.get(), fileNameBmp.data());
     if (!isOk) {
         if (error)
             *error = SDL_GetError();
@@ -253,12 +187,192 @@ bool TextureLoader::loadCountAnimationFromBmpFile(std::string_view fileName, int
     return true;
 }
 
+SurfacePtr TextureLoader::decodeImageFromFile(std::string_view fileName, bool use16Bit, std::string* error)
+{
+    Tracy_ZoneScoped;
+    SurfacePtr surface = AssetCache::loadSurface(fileName, use16Bit ? SDL_PIXELFORMAT_RGB565 : SDL_PIXELFORMAT_RGBA32);
+    if (surface)
+        return surface;
+
+    MappedFile fileData = FileUtils::mapFile(fileName, error);
+    if (!fileData)
+        return {};
+
+    surface = decodeImageFromMemory(fileData.data(), use16Bit, error);
+    if (surface) {
+        AssetCache::storeSurface(fileName, fileData.data(), surface.get());
+    }
+    return surface;
+}
+
+SurfacePtr TextureLoader::decodeImageFromMemory(std::span<const uint8_t> memory, bool use16Bit, std::string* error)
+{
+    Tracy_ZoneScoped;
+    int imageWidth = 0;
+    int imageHeight = 0;
+    int channels = use16Bit ? 3 : 4;
+    Tracy_ZoneStartN("stbImageLoad");
+    std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> imageDataPtr = {
+        stbi_load_from_memory((const stbi_uc*)memory.data(), (int)memory.size(), &imageWidth, &imageHeight, NULL, channels),
+        stbi_image_free
+    };
+    Tracy_ZoneEnd();
+
+    if (!imageDataPtr) {
+        if (error)
+            *error = std::string(stbi_failure_reason());
+        return {};
+    }
+
+    SurfacePtr surface(SDL_CreateSurface(imageWidth, imageHeight, use16Bit ? SDL_PIXELFORMAT_RGB565
+                                                                           : SDL_PIXELFORMAT_RGBA32));
+    if (!surface) {
+        if (error)
+            *error = SDL_GetError();
+        return {};
+    }
+
+    {
+        Tracy_ZoneScopedN("convertPixels");
+        const int srcPitch = channels * imageWidth;
+        bool isOk = SDL_ConvertPixels(imageWidth, imageHeight,
+                                      use16Bit ? SDL_PIXELFORMAT_RGB24 : SDL_PIXELFORMAT_RGBA32, imageDataPtr.get(), srcPitch,
+                                      surface->format, surface->pixels, surface->pitch);
+        if (!isOk) {
+            if (error)
+                *error = std::string(SDL_GetError());
+            return {};
+        }
+    }
+
+    return surface;
+}
+
+bool TextureLoader::decodeCsxFile(std::string_view fileName, IndexedImage& outImage, std::string* error)
+{
+    Tracy_ZoneScoped;
+    if (AssetCache::loadIndexedImage(fileName, outImage))
+        return true;
+
+    MappedFile fileData = FileUtils::mapFile(fileName, error);
+    if (!fileData)
+        return false;
+
+    CSX_Parser csxParser(fileData.data());
+    if (!csxParser.preParse(error))
+        return false;
+
+    const CsxMetaInfo& metaInfo = csxParser.metaInfo();
+    outImage.width = metaInfo.width;
+    outImage.height = metaInfo.height;
+    outImage.frameHeight = metaInfo.height;
+    outImage.palette = metaInfo.colors;
+    outImage.pixels.assign((size_t)metaInfo.width * metaInfo.height, 0);
+
+    // Буфер уже заполнен нулевым индексом
+    const bool needFillColor = (metaInfo.fillColorIndex != 0);
+    csxParser.parseLines(outImage.pixels, metaInfo.width, needFillColor, 0, metaInfo.height);
+
+    AssetCache::storeIndexedImage(fileName, fileData.data(), outImage);
+    return true;
+}
+
+bool TextureLoader::decodeHeightAnimationFromCsxFile(std::string_view fileName, int height, IndexedImage& outImage, std::string* error)
+{
+    Tracy_ZoneScoped;
+    return decodeAnimationFromCsxFile(fileName, IntParam::kHeight, height, false, outImage, error);
+}
+
+Texture TextureLoader::createTextureFromIndexedFrame(const IndexedImage& image, int frameIndex, SDL_Renderer* renderer, std::string* error)
+{
+    Tracy_ZoneScoped;
+    assert(frameIndex >= 0 && frameIndex < image.frameCount());
+
+    const int lineCount = image.frameLineCount(frameIndex);
+    Texture texture = Texture::create(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, image.width, lineCount, error);
+    if (!texture)
+        return texture;
+
+    // Палитра раскрывается в промежуточный буфер, общий для всех кадров потока.
+    // Размер буфера ограничен, большие кадры загружаются полосами
+    constexpr size_t kStagingPixels = 512 * 1024;
+    thread_local std::vector<uint32_t> stagingBuffer(kStagingPixels);
+    const int stripLineCount = std::max(1, (int)(kStagingPixels / image.width));
+    if (stagingBuffer.size() < (size_t)image.width * stripLineCount) {
+        stagingBuffer.resize((size_t)image.width * stripLineCount);
+    }
+
+    const uint8_t* indexes = image.pixels.data() + (size_t)frameIndex * image.frameHeight * image.width;
+    for (int y = 0; y < lineCount; y += stripLineCount) {
+        SDL_Rect rect(0, y, image.width, std::min(stripLineCount, lineCount - y));
+        const size_t pixelCount = (size_t)rect.w * rect.h;
+        const uint8_t* stripIndexes = indexes + (size_t)y * image.width;
+        for (size_t i = 0; i < pixelCount; ++i) {
+            stagingBuffer[i] = image.palette[stripIndexes[i]];
+        }
+
+        if (!texture.updatePixels(stagingBuffer.data(), &rect, error)) {
+            return Texture();
+        }
+    }
+
+    SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+bool TextureLoader::createTexturesFromIndexedImage(const IndexedImage& image, SDL_Renderer* renderer, std::vector<Texture>& outTextures, std::string* error)
+{
+    Tracy_ZoneScoped;
+    const int frameCount = image.frameCount();
+    outTextures.reserve(outTextures.size() + frameCount);
+    for (int i = 0; i < frameCount; ++i) {
+        Tracy_ZoneScopedN("Create texture");
+        Tracy_ZoneTextF("%d", i);
+        Texture texture = createTextureFromIndexedFrame(image, i, renderer, error);
+        if (!texture) {
+            return false;
+        }
+        outTextures.push_back(std::move(texture));
+    }
+    return true;
+}
+
+bool TextureLoader::have16BitSupport(SDL_Renderer* renderer)
+{
+    SDL_PropertiesID props = SDL_GetRendererProperties(renderer);
+    const SDL_PixelFormat* formats = (const SDL_PixelFormat*)SDL_GetPointerProperty(props, SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER, NULL);
+    if (formats) {
+        int i = 0;
+        while (formats[i] != SDL_PIXELFORMAT_UNKNOWN) {
+            if (formats[i] == SDL_PIXELFORMAT_RGB565) {
+                return true;
+            }
+            ++i;
+        }
+    }
+    return false;
+}
+
 bool TextureLoader::loadAnimationFromCsxFile(std::string_view fileName,
                                              IntParam type, int param,
                                              bool keepPartialFrame,
                                              SDL_Renderer* renderer,
                                              std::vector<Texture>& outTextures,
                                              std::string* error)
+{
+    Tracy_ZoneScoped;
+    IndexedImage image;
+    if (!decodeAnimationFromCsxFile(fileName, type, param, keepPartialFrame, image, error))
+        return false;
+
+    return createTexturesFromIndexedImage(image, renderer, outTextures, error);
+}
+
+bool TextureLoader::decodeAnimationFromCsxFile(std::string_view fileName,
+                                               IntParam type, int param,
+                                               bool keepPartialFrame,
+                                               IndexedImage& outImage,
+                                               std::string* error)
 {
     Tracy_ZoneScoped;
     if (param <= 0) {
@@ -267,91 +381,48 @@ bool TextureLoader::loadAnimationFromCsxFile(std::string_view fileName,
         return false;
     }
 
-    std::vector<uint8_t> fileData = FileUtils::loadFile(fileName, error);
-    if (fileData.empty())
-        return false;
-
-    CSX_Parser csxParser(fileData);
-    if (!csxParser.preParse(error))
+    // Файл декодируется целиком (или берётся из AssetCache), затем делится на кадры
+    if (!decodeCsxFile(fileName, outImage, error))
         return false;
 
+    const int csxHeight = outImage.height;
     int frameHeight;
     bool havePartialFrame = false;
     if (type == IntParam::kHeight) {
         frameHeight = param;
-        if (csxParser.metaInfo().height % param != 0) {
+        if (csxHeight % param != 0) {
             if (!keepPartialFrame) {
                 LogFmt("Warning in {}: (csxHeight % frameHeight != 0) [csxHeight: {}, framesCount: {}, frameHeight: {}]",
-                       StringUtils::filename(fileName), csxParser.metaInfo().height, csxParser.metaInfo().height / param, frameHeight);
+                       StringUtils::filename(fileName), csxHeight, csxHeight / param, frameHeight);
             }
             havePartialFrame = true;
         }
     } else if (type == IntParam::kCount) {
-        frameHeight = csxParser.metaInfo().height / param;
-        if (csxParser.metaInfo().height % param != 0) {
+        frameHeight = csxHeight / param;
+        if (csxHeight % param != 0) {
             if (!keepPartialFrame) {
                 LogFmt("Warning in {}: (csxHeight % framesCount != 0) [csxHeight: {}, framesCount: {}, frameHeight: {}]",
-                       StringUtils::filename(fileName), csxParser.metaInfo().height, param, frameHeight);
+                       StringUtils::filename(fileName), csxHeight, param, frameHeight);
             }
             havePartialFrame = true;
         }
     }
 
-    // Кадры одинаковой высоты
-    int countTextures = csxParser.metaInfo().height / frameHeight;
-    if (countTextures > 0) {
-        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surfacePtr{
-            SDL_CreateSurface(csxParser.metaInfo().width, frameHeight, SDL_PIXELFORMAT_INDEX8),
-            SDL_DestroySurface
-        };
-
-        if (!surfacePtr) {
-            if (error)
-                *error = SDL_GetError();
-            return false;
-        }
-
-        for (int i = 0; i < countTextures; ++i) {
-            Tracy_ZoneScopedN("Create texture");
-            Tracy_ZoneTextF("%d", i);
-            int lineIndexStart = i * frameHeight;
-            csxParser.parseLinesToSurface(surfacePtr.get(), true, lineIndexStart, frameHeight, false, error);
-            Texture texture = Texture::createFromSurface(renderer, surfacePtr.get(), error);
-            if (!texture) {
-                return false;
-            }
-
-            //SDL_SetTexturePalette(texture.get(), csxParser.metaInfo().pallete);
-            SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_BLEND);
-            outTextures.push_back(std::move(texture));
-        }
+    if (frameHeight <= 0) {
+        if (error)
+            *error = "Invalid param: frame height must be > 0";
+        return false;
     }
 
-    // Если высота не делится нацело добавим ещё один кадр с остатком этой высоты
+    // Кадры одинаковой высоты. Если высота не делится нацело, остаток либо отбрасывается, либо становится последним кадром
+    int countTextures = csxHeight / frameHeight;
+    int lineCount = countTextures * frameHeight;
     if (keepPartialFrame && havePartialFrame) {
-        int lineIndexStart = countTextures * frameHeight;
-        int partialHeight = csxParser.metaInfo().height - lineIndexStart;
-
-        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> partSurfacePtr = {
-            SDL_CreateSurface(csxParser.metaInfo().width, partialHeight, SDL_PIXELFORMAT_INDEX8),
-            SDL_DestroySurface
-        };
-
-        if (!partSurfacePtr) {
-            if (error)
-                *error = SDL_GetError();
-            return false;
-        }
-
-        csxParser.parseLinesToSurface(partSurfacePtr.get(), true, lineIndexStart, partialHeight, false, error);
-        Texture texture = Texture::createFromSurface(renderer, partSurfacePtr.get(), error);
-        if (!texture) {
-            return false;
-        }
-
-        //SDL_SetTexturePalette(texture.get(), csxParser.metaInfo().pallete);
-        SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_BLEND);
-        outTextures.push_back(std::move(texture));
+        lineCount = csxHeight;
     }
+
+    outImage.height = lineCount;
+    outImage.frameHeight = frameHeight;
+    outImage.pixels.resize((size_t)outImage.width * lineCount);
     return true;
 }
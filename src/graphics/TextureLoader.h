@@ -5,6 +5,9 @@
 #include <cstdint>
 #include <string_view>
 
+#include "IndexedImage.h"
+#include "Surface.h"
+
 class Texture;
 struct SDL_Renderer;
 struct SDL_Color;
@@ -26,6 +29,17 @@ public:
     static bool loadCountAnimationFromCsxFile(std::string_view fileName, int count, SDL_Renderer* renderer, std::vector<Texture>& outTextures, std::string* error = nullptr);
     static bool loadCountAnimationFromBmpFile(std::string_view fileName, int count, SDL_Renderer* renderer, std::vector<Texture>& outTextures, const SDL_Color* transparentColor, std::string* error = nullptr);
 
+    // Декодирование в SDL_Surface без рендерера. Можно вызывать из рабочих потоков
+    static SurfacePtr decodeImageFromFile(std::string_view fileName, bool use16Bit, std::string* error = nullptr);
+    static SurfacePtr decodeImageFromMemory(std::span<const uint8_t> memory, bool use16Bit, std::string* error = nullptr);
+    static bool decodeCsxFile(std::string_view fileName, IndexedImage& outImage, std::string* error = nullptr);
+    static bool decodeHeightAnimationFromCsxFile(std::string_view fileName, int height, IndexedImage& outImage, std::string* error = nullptr);
+
+    // Только из потока рендера
+    static Texture createTextureFromIndexedFrame(const IndexedImage& image, int frameIndex, SDL_Renderer* renderer, std::string* error = nullptr);
+    static bool createTexturesFromIndexedImage(const IndexedImage& image, SDL_Renderer* renderer, std::vector<Texture>& outTextures, std::string* error = nullptr);
+    static bool have16BitSupport(SDL_Renderer* renderer);
+
 private:
     enum class IntParam {
         kHeight,
@@ -37,4 +51,9 @@ private:
                                          SDL_Renderer* renderer,
                                          std::vector<Texture>& outTextures,
                                          std::string* error);
+    static bool decodeAnimationFromCsxFile(std::string_view fileName,
+                                           IntParam type, int param,
+                                           bool keepPartialFrame,
+                                           IndexedImage& outImage,
+                                           std::string* error);
 };
@@ -2,13 +2,22 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <array>
+#include <bit>
 
 #include "SDL3/SDL_surface.h"
 
 #include "utils/TracyProfiler.h"
+#include "utils/Platform.h"
 #include "utils/IoUtils.h"
 
+#if BX_SIMD_AVX2 || BX_SIMD_SSE2
+  #include <immintrin.h>
+#elif BX_SIMD_NEON
+  #include <arm_neon.h>
+#endif
+
 using namespace IoUtils;
 
 union ColorData {
@@ -21,7 +30,7 @@ union ColorData {
     };
 };
 
-CSX_Parser::CSX_Parser(std::span<uint8_t> buffer) :
+CSX_Parser::CSX_Parser(std::span<const uint8_t> buffer) :
     m_buffer(buffer)
 {
 
@@ -150,15 +159,14 @@ bool CSX_Parser::preParse(std::string* error)
     m_metaInfo.pallete = SDL_CreatePalette(m_metaInfo.colorCount);
     SDL_SetPaletteColors(m_metaInfo.pallete, palleteColors.data(), 0, m_metaInfo.colorCount);
 
+    static_assert(sizeof(SDL_Color) == sizeof(uint32_t));
+    std::memcpy(m_metaInfo.colors.data(), palleteColors.data(), m_metaInfo.colorCount * sizeof(uint32_t));
+
     return true;
 }
 
 bool CSX_Parser::parseLinesToSurface(SDL_Surface* inOutSurface, bool needFillColor, int lineIndexStart, int lineCount, bool isBackgroundTransparent, std::string* error)
 {
-    // Заливка цветом
-    if (needFillColor)
-        SDL_FillSurfaceRect(inOutSurface, NULL, m_metaInfo.fillColorIndex);
-
     // Прикрепляем палитру
     SDL_SetSurfacePalette(inOutSurface, m_metaInfo.pallete);
 
@@ -167,60 +175,116 @@ bool CSX_Parser::parseLinesToSurface(SDL_Surface* inOutSurface, bool needFillCol
         SDL_SetSurfaceColorKey(inOutSurface, true, m_metaInfo.fillColorIndex);
     }
 
-    // Декодируем изображение
     std::span<uint8_t> pixels((uint8_t*)inOutSurface->pixels, inOutSurface->pitch * lineCount);
+    parseLines(pixels, inOutSurface->pitch, needFillColor, lineIndexStart, lineCount);
+    return true;
+}
+
+void CSX_Parser::parseLines(std::span<uint8_t> pixels, size_t pitch, bool needFillColor, int lineIndexStart, int lineCount)
+{
+    assert(pixels.size() >= pitch * lineCount);
+
+    // Заливка цветом
+    if (needFillColor)
+        std::fill(pixels.begin(), pixels.end(), (uint8_t)m_metaInfo.fillColorIndex);
+
+    // Декодируем изображение
     #pragma omp parallel for
     for (int y = lineIndexStart; y < lineIndexStart + lineCount; y++) {
         size_t byteIndex = m_metaInfo.lineOffsets[y];
-        size_t pixelIndex = (y - lineIndexStart) * inOutSurface->pitch;
+        size_t pixelIndex = (y - lineIndexStart) * pitch;
         size_t byteCount = m_metaInfo.lineOffsets[y + 1] - m_metaInfo.lineOffsets[y];
         decodeLine(m_metaInfo.bytes, byteIndex, pixels, pixelIndex, byteCount);
     }
+}
 
-    return true;
+// Команды RLE занимают диапазон [0x69, 0x6C], все остальные байты - обычные цвета
+static constexpr uint8_t kCommandFirst = 0x69;
+static constexpr uint8_t kCommandCount = 4;
+
+// Количество байт до первой команды (или count, если команд нет)
+static size_t literalRunLength(const uint8_t* bytes, size_t count) noexcept {
+    size_t i = 0;
+
+    // (byte - 0x69) <= 3 без знака: min(v, 3) == v
+#if BX_SIMD_AVX2
+    const __m256i first32 = _mm256_set1_epi8((char)kCommandFirst);
+    const __m256i last32 = _mm256_set1_epi8(kCommandCount - 1);
+    for (; i + 32 <= count; i += 32) {
+        __m256i v = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(bytes + i)), first32);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(v, last32), v));
+        if (mask)
+            return i + std::countr_zero(mask);
+    }
+#endif
+
+#if BX_SIMD_SSE2
+    const __m128i first16 = _mm_set1_epi8((char)kCommandFirst);
+    const __m128i last16 = _mm_set1_epi8(kCommandCount - 1);
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(bytes + i)), first16);
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(v, last16), v));
+        if (mask)
+            return i + std::countr_zero(mask);
+    }
+#elif BX_SIMD_NEON
+    const uint8x16_t first16 = vdupq_n_u8(kCommandFirst);
+    const uint8x16_t last16 = vdupq_n_u8(kCommandCount - 1);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t isCommand = vcleq_u8(vsubq_u8(vld1q_u8(bytes + i), first16), last16);
+        // Сужение до 4 бит на байт вместо отсутствующего в NEON movemask
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(isCommand), 4)), 0);
+        if (mask)
+            return i + (std::countr_zero(mask) >> 2);
+    }
+#endif
+
+    // Хвост (и вариант без SIMD)
+    for (; i < count; ++i) {
+        if (uint8_t(bytes[i] - kCommandFirst) < kCommandCount)
+            return i;
+    }
+    return count;
 }
 
 void CSX_Parser::decodeLine(std::span<const uint8_t> bytes, size_t byteIndex, std::span<uint8_t> pixels, size_t pixelIndex, size_t byteCount) {
-    while (byteCount > 0) {
-        uint8_t x = bytes[byteIndex];
-        byteIndex++;
-        byteCount--;
-
-        switch (x) {
+    const uint8_t* src = bytes.data() + byteIndex;
+    const uint8_t* srcEnd = src + byteCount;
+    uint8_t* dst = pixels.data() + pixelIndex;
+
+    while (src < srcEnd) {
+        // Серия обычных цветов копируется целиком
+        size_t literalCount = literalRunLength(src, srcEnd - src);
+        std::memcpy(dst, src, literalCount);
+        src += literalCount;
+        dst += literalCount;
+        if (src == srcEnd)
+            break;
+
+        switch (*src++) {
             case 107: { // [0x6B] Экранирование. Следующий байт - обычный цвет (для интерпретации 0x6B, 0x69, 0x6A, 0x6C как цвет, а не как команды)
-                pixels[pixelIndex] = bytes[byteIndex];
-                byteIndex++;
-                byteCount--;
-                pixelIndex++;
+                *dst++ = *src++;
                 break;
             }
             case 105: { // [0x69] Прозрачный пиксель
-                pixelIndex++;
+                dst++;
                 break;
             }
             case 106: { // [0x6A] Заполненный цвет
-                auto runLength = bytes[byteIndex + 1];
-                uint8_t colorIndex = bytes[byteIndex];
-                std::fill_n(pixels.begin() + pixelIndex, runLength, colorIndex);
-                byteCount -= 2;
-                byteIndex += 2;
-                pixelIndex += runLength;
+                uint8_t colorIndex = src[0];
+                uint8_t runLength = src[1];
+                std::memset(dst, colorIndex, runLength);
+                src += 2;
+                dst += runLength;
                 break;
             }
             case 108: { // [0x6C] Заполнение прозрачным
-                auto runLength = bytes[byteIndex];
-                byteIndex++;
-                byteCount--;
-                pixelIndex += runLength;
-                break;
-            }
-            default: { // Обычный цвет
-                pixels[pixelIndex] = x;
-                pixelIndex++;
+                dst += *src++;
                 break;
             }
         }
     }
+    assert(dst <= pixels.data() + pixels.size());
 }
 
 const CsxMetaInfo& CSX_Parser::metaInfo() const {
@@ -1,5 +1,6 @@
 #include <cstdint>
 #include <string>
+#include <array>
 #include <span>
 
 struct SDL_Surface;
@@ -17,17 +18,19 @@ struct CsxMetaInfo {
     std::span<const uint8_t> bytes;
 
     SDL_Palette* pallete = nullptr;
+    std::array<uint32_t, kMaxColors> colors = {}; // Та же палитра в порядке байт SDL_PIXELFORMAT_RGBA32
 };
 
 class CSX_Parser {
 public:
-    CSX_Parser(std::span<uint8_t> buffer);
+    CSX_Parser(std::span<const uint8_t> buffer);
     ~CSX_Parser();
 
     SDL_Surface* parse(bool isBackgroundTransparent = true, std::string* error = nullptr);
 
     bool preParse(std::string* error = nullptr);
     bool parseLinesToSurface(SDL_Surface* inOutSurface, bool needFillColor, int lineIndexStart, int lineCount, bool isBackgroundTransparent = true, std::string* error = nullptr);
+    void parseLines(std::span<uint8_t> pixels, size_t pitch, bool needFillColor, int lineIndexStart, int lineCount); // Индексы палитры без SDL_Surface
 
     const CsxMetaInfo& metaInfo() const;
 
@@ -36,6 +39,6 @@ private:
                     std::span<uint8_t> pixels, size_t pixelIndex,
                     size_t byteCount);
 
-    std::span<uint8_t> m_buffer;
+    std::span<const uint8_t> m_buffer;
     CsxMetaInfo m_metaInfo;
 };
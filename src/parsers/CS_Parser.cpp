@@ -14,7 +14,7 @@
 
 using namespace IoUtils;
 
-void CS_Node::toStringBuffer(std::span<char> buffer, bool showDialogPhrases, const std::map<int, std::string>& sdbDialogStrings) const {
+void CS_Node::toStringBuffer(std::span<char> buffer, bool showDialogPhrases, const SDB_Strings& sdbDialogStrings) const {
     char additionInfo[3584];
     additionInfo[0] = '\0';
     if (opcode >= 0 && opcode <= 20) {
@@ -92,10 +92,11 @@ void CS_Data::insertNodes(size_t pos, std::span<const CS_Node> newNodes) {
 bool CS_Parser::parse(std::string_view csPath, CS_Data& data, std::string* error)
 {
     Tracy_ZoneScoped;
-    auto fileData = FileUtils::loadFile(csPath, error);
-    if (fileData.empty()) {
+    MappedFile mappedFile = FileUtils::mapFile(csPath, error);
+    if (!mappedFile) {
         return false;
     }
+    std::span<const uint8_t> fileData = mappedFile.data();
 
     size_t offset = 0;
     size_t fileSize = readUInt32(fileData, offset);
@@ -112,19 +113,14 @@ bool CS_Parser::parse(std::string_view csPath, CS_Data& data, std::string* error
         }
 
         if (node.opcode >= 0 && node.opcode <= 20 || node.opcode == kAssign) {
-            node.a = readInt32(fileData, offset);
-            node.b = readInt32(fileData, offset);
-            node.c = readInt32(fileData, offset);
-            node.d = readInt32(fileData, offset);
+            std::tie(node.a, node.b, node.c, node.d) = readRecord<RecordLayout<int32_t, int32_t, int32_t, int32_t>>(fileData, offset);
         } else if (node.opcode == kNumberVarName || node.opcode == kNumberLiteral) {
             node.value = readDouble(fileData, offset);
         } else if (node.opcode == kStringVarName || node.opcode == kStringLiteral) {
             std::string_view text = readCString(fileData, offset);
             node.text = std::string(text);
         } else if (node.opcode == kFunc) {
-            node.c = readInt32(fileData, offset);
-            node.d = readInt32(fileData, offset);
-            node.value = readDouble(fileData, offset);
+            std::tie(node.c, node.d, node.value) = readRecord<RecordLayout<int32_t, int32_t, double>>(fileData, offset);
 
             for (int i = 0; i < node.args.size(); ++i) {
                 node.args[i] = readInt32(fileData, offset);
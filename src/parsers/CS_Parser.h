@@ -4,7 +4,8 @@
 #include <vector>
 #include <array>
 #include <span>
-#include <map>
+
+#include "parsers/SDB_Parser.h"
 
 struct CS_Node {
     int32_t opcode = -1;
@@ -19,7 +20,7 @@ struct CS_Node {
     std::string text;
     double value = -1.0;
 
-    void toStringBuffer(std::span<char> buffer, bool showDialogPhrases, const std::map<int, std::string>& sdbDialogStrings = {}) const;
+    void toStringBuffer(std::span<char> buffer, bool showDialogPhrases, const SDB_Strings& sdbDialogStrings = {}) const;
 };
 
 struct CS_Data {
@@ -7,25 +7,23 @@ using namespace IoUtils;
 
 std::optional<LAO_Data> LAO_Parser::parse(std::string_view laoPath, std::string* error = nullptr)
 {
-    auto fileData = FileUtils::loadFile(laoPath, error);
-    if (fileData.empty()) {
+    MappedFile mappedFile = FileUtils::mapFile(laoPath, error);
+    if (!mappedFile) {
         return {};
     }
+    std::span<const uint8_t> fileData = mappedFile.data();
 
-    if (fileData.size() % 8 != 0) {
-        if (error)
-            *error = "Incorrect data";
-        return {};
-    }
+    // Запись: высота кадра и длительность
+    using InfoLayout = RecordLayout<uint32_t, uint32_t>;
 
+    // Неполная запись в конце файла - ошибка, а не отброшенный хвост
     std::optional<LAO_Data> result = LAO_Data();
-
     size_t offset = 0;
-    while (offset < fileData.size()) {
-        uint32_t height = readUInt32(fileData, offset);
-        uint32_t duration = readUInt32(fileData, offset);
-
-        result->infos.emplace_back(height, duration);
+    if (fileData.size() % InfoLayout::kSize != 0 ||
+        !readRecords<InfoLayout>(fileData, offset, fileData.size() / InfoLayout::kSize, result->infos)) {
+        if (error)
+            *error = "Incorrect data";
+        return {};
     }
     return result;
 }
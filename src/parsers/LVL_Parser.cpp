@@ -5,10 +5,27 @@
 #include "utils/IoUtils.h"
 #include "utils/FileUtils.h"
 #include "utils/TracyProfiler.h"
+#include "utils/Platform.h"
+
+#if BX_SIMD_AVX2
+  #include <immintrin.h>
+#elif BX_SIMD_NEON
+  #include <arm_neon.h>
+#endif
 
 using namespace IoUtils;
 using namespace std::literals::string_view_literals;
 
+// relief, sound, mask
+using MapTileLayout = RecordLayout<uint16_t, uint16_t, uint16_t>;
+// Выравнивание, number, x, y
+using MaskDescriptionLayout = RecordLayout<uint32_t, uint32_t, uint32_t, uint32_t>;
+using TilePositionLayout = RecordLayout<uint16_t, uint16_t>;
+// param1, param2, number, position.x, position.y (за ними следует имя)
+using DescriptionLayout = RecordLayout<uint16_t, uint16_t, uint32_t, int32_t, int32_t>;
+// Поля ExtraSound после пути
+using ExtraSoundLayout = RecordLayout<float, float, float, float, float, float, float, float, uint32_t, uint32_t, uint32_t, uint32_t>;
+
 using BlockParser = void(*)(std::span<const uint8_t>, LVL_Data&);
 struct BlockParserEntry {
     std::string_view name;
@@ -44,10 +61,11 @@ struct ParsersPrivate {
 
 bool LVL_Parser::parse(std::string_view lvlPath, LVL_Data& data, std::string* error) {
     Tracy_ZoneScoped;
-    auto fileData = FileUtils::loadFile(lvlPath, error);
-    if (fileData.empty()) {
+    MappedFile mappedFile = FileUtils::mapFile(lvlPath, error);
+    if (!mappedFile) {
         return false;
     }
+    std::span<const uint8_t> fileData = mappedFile.data();
 
     // В файле уровня должны присутствовать все 12 блоков данных
     // Блоки данных следуют друг за другом в строгой последовательности
@@ -87,15 +105,13 @@ bool LVL_Parser::save(std::string_view lvlPath, const LVL_Data& data, std::strin
     writeUInt32(saveData, data.mapSize.pixelHeight);
 
     writeString(saveData, ParsersPrivate::kParsers[BLK_MHDR].name);
-    writeUInt32(saveData, 8 + (data.mapTiles.chunks.size() * 4 * 6));
+    writeUInt32(saveData, 8 + (data.mapTiles.tileCount() * MapTileLayout::kSize));
     writeUInt32(saveData, data.mapTiles.chunkWidth);
     writeUInt32(saveData, data.mapTiles.chunkHeight);
-    for (const auto& chunk : data.mapTiles.chunks) {
-        for (const auto& tile : chunk) {
-            writeUInt16(saveData, tile.relief);
-            writeUInt16(saveData, tile.sound);
-            writeUInt16(saveData, tile.mask);
-        }
+    for (size_t i = 0; i < data.mapTiles.tileCount(); ++i) {
+        writeUInt16(saveData, data.mapTiles.relief[i]);
+        writeUInt16(saveData, data.mapTiles.sound[i]);
+        writeUInt16(saveData, data.mapTiles.mask[i]);
     }
 
     writeString(saveData, ParsersPrivate::kParsers[BLK_MDSC].name);
@@ -240,21 +256,84 @@ void LVL_Parser::parseMapTiles(std::span<const uint8_t> block, LVL_Data& data) {
     data.mapTiles.chunkHeight = readUInt32(block, offset);
 
     const size_t nChunks = data.mapTiles.chunkWidth * data.mapTiles.chunkHeight;
-    assert(block.size() == offset + nChunks * 6 * 4);
-    data.mapTiles.chunks.reserve(nChunks);
-    for (size_t i = 0; i < nChunks; ++i) {
-        MapChunk chunk;
-        for (size_t t = 0; t < chunk.size(); ++t) {
-            MapTile tile;
-            tile.relief = readUInt16(block, offset);
-            tile.sound = readUInt16(block, offset);
-            tile.mask = readUInt16(block, offset);
-            chunk[t] = std::move(tile);
+    const size_t nTiles = nChunks * MapTiles::kTilesPerChunk;
+    assert(block.size() == offset + nTiles * MapTileLayout::kSize);
+    if (!hasRecords<MapTileLayout>(block, offset, nTiles))
+        return;
+
+    data.mapTiles.resize(nChunks);
+    deinterleaveTiles(block.data() + offset, nTiles, data.mapTiles);
+    offset += nTiles * MapTileLayout::kSize;
+
+    assert(block.size() == offset);
+}
+
+// Тройки relief/sound/mask раскладываются по плоскостям
+void LVL_Parser::deinterleaveTiles(const uint8_t* tiles, size_t count, MapTiles& output) {
+    Tracy_ZoneScoped;
+    uint16_t* relief = output.relief.data();
+    uint16_t* sound = output.sound.data();
+    uint16_t* mask = output.mask.data();
+    size_t i = 0;
+
+#if BX_SIMD_NEON
+    for (; i + 8 <= count; i += 8) {
+        uint16x8x3_t planes = vld3q_u16((const uint16_t*)(tiles + i * MapTileLayout::kSize));
+        vst1q_u16(relief + i, planes.val[0]);
+        vst1q_u16(sound + i, planes.val[1]);
+        vst1q_u16(mask + i, planes.val[2]);
+    }
+#elif BX_SIMD_AVX2
+    // 8 тайлов = 48 байт = три регистра. Для каждой плоскости pshufb выбирает её слова из каждого регистра
+    // (-1 обнуляет байт), затем три результата объединяются
+    auto shuffleMask = [] (int plane, int part) {
+        alignas(16) int8_t bytes[16];
+        for (int word = 0; word < 8; ++word) {
+            int source = word * 3 + plane - part * 8; // Номер слова внутри регистра part
+            bool inPart = source >= 0 && source < 8;
+            bytes[word * 2]     = inPart ? (int8_t)(source * 2) : -1;
+            bytes[word * 2 + 1] = inPart ? (int8_t)(source * 2 + 1) : -1;
+        }
+        return _mm_load_si128((const __m128i*)bytes);
+    };
+    __m128i masks[3][3];
+    for (int plane = 0; plane < 3; ++plane) {
+        for (int part = 0; part < 3; ++part) {
+            masks[plane][part] = shuffleMask(plane, part);
         }
-        data.mapTiles.chunks.push_back(std::move(chunk));
     }
 
-    assert(block.size() == offset);
+    uint16_t* planes[3] = {relief, sound, mask};
+    for (; i + 8 <= count; i += 8) {
+        const uint8_t* source = tiles + i * MapTileLayout::kSize;
+        __m128i part0 = _mm_loadu_si128((const __m128i*)source);
+        __m128i part1 = _mm_loadu_si128((const __m128i*)(source + 16));
+        __m128i part2 = _mm_loadu_si128((const __m128i*)(source + 32));
+        for (int plane = 0; plane < 3; ++plane) {
+            __m128i result = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(part0, masks[plane][0]),
+                                                       _mm_shuffle_epi8(part1, masks[plane][1])),
+                                          _mm_shuffle_epi8(part2, masks[plane][2]));
+            _mm_storeu_si128((__m128i*)(planes[plane] + i), result);
+        }
+    }
+#endif
+
+    // Хвост (и вариант без SIMD)
+    std::span<const uint8_t> rest(tiles + i * MapTileLayout::kSize, (count - i) * MapTileLayout::kSize);
+    size_t offset = 0;
+    forEachRecord<MapTileLayout>(rest, offset, count - i, [&] (uint16_t reliefValue, uint16_t soundValue, uint16_t maskValue) {
+        relief[i] = reliefValue;
+        sound[i] = soundValue;
+        mask[i] = maskValue;
+        ++i;
+    });
+}
+
+void MapTiles::resize(size_t chunkCount) {
+    const size_t tileCount = chunkCount * kTilesPerChunk;
+    relief.resize(tileCount);
+    sound.resize(tileCount);
+    mask.resize(tileCount);
 }
 
 void LVL_Parser::parseMaskDescriptions(std::span<const uint8_t> block, LVL_Data& data) {
@@ -264,15 +343,11 @@ void LVL_Parser::parseMaskDescriptions(std::span<const uint8_t> block, LVL_Data&
     uint32_t count = readUInt32(block, offset);
     data.maskDescriptions.reserve(count);
 
-    assert(block.size() == offset + count * 16);
-    for (size_t i = 0; i < count; ++i) {
-        MaskDescription mask;
-        offset += 4; // skip padding
-        mask.number = readUInt32(block, offset);
-        mask.x = readUInt32(block, offset);
-        mask.y = readUInt32(block, offset);
-        data.maskDescriptions.push_back(std::move(mask));
-    }
+    assert(block.size() == offset + count * MaskDescriptionLayout::kSize);
+    [[maybe_unused]] bool isOk = forEachRecord<MaskDescriptionLayout>(block, offset, count, [&] (uint32_t /*padding*/, uint32_t number, uint32_t x, uint32_t y) {
+        data.maskDescriptions.push_back({number, x, y});
+    });
+    assert(isOk);
     assert(block.size() == offset);
 }
 
@@ -300,13 +375,8 @@ void LVL_Parser::parseCellGroups(std::span<const uint8_t> block, LVL_Data& data)
         cellGroup.name = readStringWithSize(block, offset);
 
         uint32_t groupSize = readUInt32(block, offset);
-        cellGroup.cells.reserve(groupSize);
-        for (uint32_t j = 0; j < groupSize; ++j) {
-            TilePosition pos;
-            pos.x = readUInt16(block, offset);
-            pos.y = readUInt16(block, offset);
-            cellGroup.cells.push_back(std::move(pos));
-        }
+        [[maybe_unused]] bool isOk = readRecords<TilePositionLayout>(block, offset, groupSize, cellGroup.cells);
+        assert(isOk);
         data.cellGroups.push_back(std::move(cellGroup));
     }
 
@@ -334,18 +404,10 @@ void LVL_Parser::parseSounds(std::span<const uint8_t> block, LVL_Data& data) {
     for (uint32_t i = 0; i < soundCount; ++i) {
         ExtraSound extraSound;
         extraSound.path = readStringWithSize(block, offset);
-        extraSound.chunkPositionX = readFloat(block, offset);
-        extraSound.chunkPositionY = readFloat(block, offset);
-        extraSound.param03 = readFloat(block, offset);
-        extraSound.param04 = readFloat(block, offset);
-        extraSound.param05 = readFloat(block, offset);
-        extraSound.param06 = readFloat(block, offset);
-        extraSound.param07 = readFloat(block, offset);
-        extraSound.param08 = readFloat(block, offset);
-        extraSound.param09 = readUInt32(block, offset);
-        extraSound.param10 = readUInt32(block, offset);
-        extraSound.param11 = readUInt32(block, offset);
-        extraSound.param12 = readUInt32(block, offset);
+        std::tie(extraSound.chunkPositionX, extraSound.chunkPositionY,
+                 extraSound.param03, extraSound.param04, extraSound.param05, extraSound.param06,
+                 extraSound.param07, extraSound.param08,
+                 extraSound.param09, extraSound.param10, extraSound.param11, extraSound.param12) = readRecord<ExtraSoundLayout>(block, offset);
         sounds.otherSounds.push_back(std::move(extraSound));
     }
     assert(block.size() == offset);
@@ -395,11 +457,7 @@ void LVL_Parser::parseStructuredBlock(std::span<const uint8_t> block, std::vecto
     data.reserve(count);
     for (size_t i = 0; i < count; ++i) {
         LVL_Description desc;
-        desc.param1 = readUInt16(block, offset);
-        desc.param2 = readUInt16(block, offset);
-        desc.number = readUInt32(block, offset);
-        desc.position.x = readInt32(block, offset);
-        desc.position.y = readInt32(block, offset);
+        std::tie(desc.param1, desc.param2, desc.number, desc.position.x, desc.position.y) = readRecord<DescriptionLayout>(block, offset);
         desc.name = readStringWithSize(block, offset);
         data.push_back(std::move(desc));
     }
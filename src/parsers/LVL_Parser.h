@@ -89,11 +89,30 @@ struct MapTile {
     static const uint16_t kEmptyMask = 0xffff;
 };
 
-using MapChunk = std::array<MapTile, 4>;
+// Тайлы карты в виде отдельных плоскостей relief/sound/mask (structure of arrays): режим отображения
+// читает только нужную плоскость. Порядок тайлов как в файле: чанки по столбцам, в чанке 2x2 тайла
+// [0] [2]
+// [1] [3]
 struct MapTiles {
+    static constexpr size_t kTilesPerChunk = 4;
+
     uint32_t chunkWidth = 0; // (Big cells)
     uint32_t chunkHeight = 0;
-    std::vector<MapChunk> chunks;
+    std::vector<uint16_t> relief;
+    std::vector<uint16_t> sound;
+    std::vector<uint16_t> mask;
+
+    size_t tileCount() const { return relief.size(); }
+    size_t chunkCount() const { return relief.size() / kTilesPerChunk; }
+    bool empty() const { return relief.empty(); }
+
+    MapTile tile(size_t tileIndex) const { return {relief[tileIndex], sound[tileIndex], mask[tileIndex]}; }
+    // Индекс в плоскостях для тайла в столбце column и строке row карты
+    size_t tileIndexAt(size_t column, size_t row) const {
+        const size_t chunkIndex = (column / 2) * chunkHeight + row / 2;
+        return chunkIndex * kTilesPerChunk + (column % 2) * 2 + row % 2;
+    }
+    void resize(size_t chunkCount);
 };
 
 struct LVL_Data {
@@ -137,4 +156,5 @@ private:
     static void parseLevelFloors(std::span<const uint8_t> block, LVL_Data& data);
 
     static void parseStructuredBlock(std::span<const uint8_t> block, std::vector<LVL_Description>& data);
+    static void deinterleaveTiles(const uint8_t* tiles, size_t count, MapTiles& output);
 };
@@ -1,18 +1,26 @@
 #include "MDF_Parser.h"
 
 #include <cassert>
+#include <format>
 
 #include "utils/IoUtils.h"
 #include "utils/FileUtils.h"
 
+using namespace IoUtils;
+
+// framesCount, xOffset, yOffset, a04, isReverse, startTimeMs, endTimeMs
+using AnimationHeaderLayout = RecordLayout<int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t>;
+
+// Поля MDF_Params в порядке объявления
+using ParamsLayout = RecordLayout<int32_t, int32_t, int32_t, int32_t, int32_t, float, float, float, float, int32_t>;
+
 std::optional<MDF_Data> MDF_Parser::parse(std::string_view path, std::string* error)
 {
-    using namespace IoUtils;
-
-    auto fileData = FileUtils::loadFile(path, error);
-    if (fileData.empty()) {
+    MappedFile mappedFile = FileUtils::mapFile(path, error);
+    if (!mappedFile) {
         return {};
     }
+    std::span<const uint8_t> fileData = mappedFile.data();
 
     // Проверка заголовка "MDF "
     size_t offset = 0;
@@ -32,32 +40,15 @@ std::optional<MDF_Data> MDF_Parser::parse(std::string_view path, std::string* er
             layer.layerNumber = i + 1;
             layer.animations.reserve(animationCount);
             for (int a = 0; a < animationCount; ++a) {
-                MDF_Animation anim;
-                anim.framesCount = readInt32(fileData, offset);
-                anim.xOffset = readInt32(fileData, offset);
-                anim.yOffset = readInt32(fileData, offset);
-                anim.a04 = readInt32(fileData, offset);
-                anim.isReverse = readInt32(fileData, offset);
-                anim.startTimeMs = readInt32(fileData, offset);
-                anim.endTimeMs = readInt32(fileData, offset);
+                MDF_Animation anim = readRecord<AnimationHeaderLayout, MDF_Animation>(fileData, offset);
                 anim.maskAnimationPath = readStringWithSize(fileData, offset);
                 anim.animationPath = readStringWithSize(fileData, offset);
 
                 int32_t paramsCount = readInt32(fileData, offset);
-                anim.params.reserve(paramsCount);
-                for (int p = 0; p < paramsCount; ++p) {
-                    MDF_Params params;
-                    params.p01 = readInt32(fileData, offset);
-                    params.p02 = readInt32(fileData, offset);
-                    params.flags = readInt32(fileData, offset);
-                    params.nFrame = readInt32(fileData, offset);
-                    params.p05 = readInt32(fileData, offset);
-                    params.delayMs = readFloat(fileData, offset);
-                    params.alpha = readFloat(fileData, offset);
-                    params.p08 = readFloat(fileData, offset);
-                    params.p09 = readFloat(fileData, offset);
-                    params.animationTimeMs = readInt32(fileData, offset);
-                    anim.params.push_back(std::move(params));
+                if (paramsCount < 0 || !readRecords<ParamsLayout>(fileData, offset, paramsCount, anim.params)) {
+                    if (error)
+                        *error = std::format("Incorrect MDF file. Params count: {}", paramsCount);
+                    return {};
                 }
                 layer.animations.push_back(std::move(anim));
             }
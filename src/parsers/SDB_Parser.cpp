@@ -1,5 +1,8 @@
 #include "SDB_Parser.h"
 
+#include <algorithm>
+#include <stdexcept>
+#include <numeric>
 #include <cassert>
 
 #include "utils/IoUtils.h"
@@ -9,13 +12,114 @@
 
 using namespace IoUtils;
 
+void SDB_Strings::clear() noexcept
+{
+    m_ids.clear();
+    m_ranges.clear();
+    m_arena.clear();
+    m_appendOffset = 0;
+    m_isSorted = true;
+    m_isDense = false;
+}
+
+SDB_Strings::const_iterator SDB_Strings::find(int id) const noexcept
+{
+    if (m_ids.empty())
+        return end();
+
+    if (m_isDense) {
+        int64_t index = (int64_t)id - m_ids.front();
+        return (index >= 0 && index < (int64_t)m_ids.size()) ? const_iterator(this, index) : end();
+    }
+
+    auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+    if (it == m_ids.end() || *it != id)
+        return end();
+    return const_iterator(this, it - m_ids.begin());
+}
+
+std::string_view SDB_Strings::at(int id) const
+{
+    auto it = find(id);
+    if (it == end())
+        throw std::out_of_range("SDB_Strings::at");
+    return (*it).second;
+}
+
+std::string_view SDB_Strings::operator[](int id) const noexcept
+{
+    auto it = find(id);
+    return (it == end()) ? std::string_view() : (*it).second;
+}
+
+void SDB_Strings::reserve(size_t count, size_t textBytes)
+{
+    m_ids.reserve(count);
+    m_ranges.reserve(count);
+    m_arena.reserve(textBytes);
+}
+
+std::span<char> SDB_Strings::appendBuffer(size_t maxTextSize)
+{
+    m_appendOffset = m_arena.size();
+    m_arena.resize(m_appendOffset + maxTextSize + 1);
+    return {m_arena.data() + m_appendOffset, maxTextSize + 1};
+}
+
+void SDB_Strings::commitAppend(int id, size_t textSize)
+{
+    if (m_isSorted && !m_ids.empty() && id <= m_ids.back()) {
+        if (id == m_ids.back()) {
+            m_arena.resize(m_appendOffset);
+            return;
+        }
+        m_isSorted = false;
+    }
+
+    m_arena.resize(m_appendOffset + textSize + 1);
+    m_arena[m_appendOffset + textSize] = '\0';
+    m_ids.push_back(id);
+    m_ranges.push_back({(uint32_t)m_appendOffset, (uint32_t)textSize});
+}
+
+void SDB_Strings::finish()
+{
+    Tracy_ZoneScoped;
+    if (!m_isSorted) {
+        // Устойчивая сортировка: из повторов остаётся первый, как при emplace в std::map
+        std::vector<uint32_t> order(m_ids.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this] (uint32_t a, uint32_t b) {
+            return m_ids[a] < m_ids[b];
+        });
+
+        std::vector<int32_t> ids;
+        std::vector<Range> ranges;
+        ids.reserve(order.size());
+        ranges.reserve(order.size());
+        for (uint32_t index : order) {
+            if (!ids.empty() && ids.back() == m_ids[index])
+                continue;
+            ids.push_back(m_ids[index]);
+            ranges.push_back(m_ranges[index]);
+        }
+        m_ids = std::move(ids);
+        m_ranges = std::move(ranges);
+        m_isSorted = true;
+    }
+
+    m_isDense = !m_ids.empty() && ((int64_t)m_ids.back() - m_ids.front() + 1 == (int64_t)m_ids.size());
+    m_arena.shrink_to_fit();
+}
+
 bool SDB_Parser::parse(std::string_view sdbPath, SDB_Data& data, std::string* error)
 {
     Tracy_ZoneScoped;
-    auto fileData = FileUtils::loadFile(sdbPath, error);
-    if (fileData.empty()) {
+    MappedFile mappedFile = FileUtils::mapFile(sdbPath, error);
+    if (!mappedFile) {
         return false;
     }
+    std::span<const uint8_t> fileData = mappedFile.data();
 
     bool xorRequired = false;
     size_t offset = 0;
@@ -24,26 +128,24 @@ bool SDB_Parser::parse(std::string_view sdbPath, SDB_Data& data, std::string* er
         offset = 0;
     }
 
-    constexpr size_t kStringTextSize = 16384;
-    char stringText[kStringTextSize];
+    // Кириллица в UTF-8 занимает два байта, запас на служебные поля записей
+    data.strings.clear();
+    data.strings.reserve(fileData.size() / 32, fileData.size() * 2);
+
+    // Один символ Win1251 даёт до трёх байт UTF-8
+    constexpr size_t kMaxUtf8PerChar = 3;
     while (offset < fileData.size()) {
         int32_t id = readInt32(fileData, offset);
         auto textSv = readStringWithSize(fileData, offset);
-        assert((textSv.size() * 2) < kStringTextSize);
-
-        if (xorRequired) {
-            char decodedText[kStringTextSize];
-            std::copy(textSv.begin(), textSv.end(), decodedText);
-            decodedText[textSv.size()] = '\0';
-            for (size_t i = 0; i < textSv.size(); ++i) {
-                decodedText[i] ^= 0xAA;
-            }
-            StringUtils::decodeWin1251ToUtf8Buffer(decodedText, stringText);
-        } else {
-            StringUtils::decodeWin1251ToUtf8Buffer(textSv, stringText);
-        }
-        data.strings.emplace_hint(data.strings.end(), id, stringText);
+
+        // Текст записи заканчивается на первом '\0' (в зашифрованном файле это 0xAA)
+        textSv = textSv.substr(0, textSv.find(xorRequired ? '\xAA' : '\0'));
+
+        std::span<char> buffer = data.strings.appendBuffer(textSv.size() * kMaxUtf8PerChar);
+        size_t textSize = StringUtils::decodeWin1251ToUtf8Buffer(textSv, buffer, xorRequired ? 0xAA : 0);
+        data.strings.commitAppend(id, textSize);
     }
+    data.strings.finish();
 
     assert(fileData.size() == offset);
     return true;
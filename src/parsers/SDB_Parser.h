@@ -1,9 +1,100 @@
 #pragma once
+#include <string_view>
+#include <iterator>
+#include <cstdint>
+#include <utility>
 #include <string>
-#include <map>
+#include <vector>
+#include <span>
+
+// Строки SDB: отсортированный массив id и смещения в общем буфере UTF-8.
+// Каждая строка в буфере завершается '\0'. Интерфейс поиска повторяет std::map<int, std::string>
+class SDB_Strings {
+public:
+    using value_type = std::pair<int, std::string_view>;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = SDB_Strings::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        struct ArrowProxy {
+            value_type value;
+            const value_type* operator->() const { return &value; }
+        };
+
+        const_iterator() noexcept = default;
+        const_iterator(const SDB_Strings* strings, size_t index) noexcept : m_strings(strings), m_index(index) {}
+
+        value_type operator*() const { return m_strings->valueAt(m_index); }
+        ArrowProxy operator->() const { return {m_strings->valueAt(m_index)}; }
+
+        const_iterator& operator++() { ++m_index; return *this; }
+        const_iterator operator++(int) { const_iterator result = *this; ++m_index; return result; }
+        const_iterator& operator--() { --m_index; return *this; }
+        const_iterator operator--(int) { const_iterator result = *this; --m_index; return result; }
+        const_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+        const_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return {m_strings, m_index + n}; }
+        friend const_iterator operator+(difference_type n, const const_iterator& it) { return it + n; }
+        const_iterator operator-(difference_type n) const { return {m_strings, m_index - n}; }
+        difference_type operator-(const const_iterator& other) const { return (difference_type)m_index - (difference_type)other.m_index; }
+        value_type operator[](difference_type n) const { return m_strings->valueAt(m_index + n); }
+
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+        auto operator<=>(const const_iterator& other) const { return m_index <=> other.m_index; }
+
+    private:
+        const SDB_Strings* m_strings = nullptr;
+        size_t m_index = 0;
+    };
+
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, m_ids.size()}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    size_t size() const noexcept { return m_ids.size(); }
+    bool empty() const noexcept { return m_ids.empty(); }
+    void clear() noexcept;
+
+    const_iterator find(int id) const noexcept;
+    bool contains(int id) const noexcept { return find(id) != end(); }
+    std::string_view at(int id) const; // std::out_of_range, если id нет
+    std::string_view operator[](int id) const noexcept; // Пустая строка, если id нет
+
+    // Заполнение при разборе: текст пишется в appendBuffer (с местом под '\0'), затем commitAppend.
+    // Повторный id игнорируется, как emplace в std::map. После заполнения вызывается finish
+    void reserve(size_t count, size_t textBytes);
+    std::span<char> appendBuffer(size_t maxTextSize);
+    void commitAppend(int id, size_t textSize);
+    void finish();
+
+    size_t arenaSize() const noexcept { return m_arena.size(); }
+
+private:
+    struct Range {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    value_type valueAt(size_t index) const noexcept {
+        return {m_ids[index], {m_arena.data() + m_ranges[index].offset, m_ranges[index].size}};
+    }
+
+    std::vector<int32_t> m_ids;
+    std::vector<Range> m_ranges;
+    std::string m_arena;
+    size_t m_appendOffset = 0;
+    bool m_isSorted = true;
+    bool m_isDense = false; // id идут подряд без пропусков, поиск по индексу
+};
 
 struct SDB_Data {
-    std::map<int, std::string> strings;
+    SDB_Strings strings;
 };
 
 class SDB_Parser
@@ -12,12 +12,13 @@
 
 bool SEF_Parser::parse(std::string_view sefPath, SEF_Data& data, std::string* error) {
     Tracy_ZoneScoped;
-    auto fileData = FileUtils::loadFile(sefPath, error);
-    if (fileData.empty()) {
+    MappedFile mappedFile = FileUtils::mapFile(sefPath, error);
+    if (!mappedFile) {
         return false;
     }
+    std::span<const uint8_t> fileData = mappedFile.data();
 
-    std::string_view fileStringView((char*)fileData.data(), fileData.size());
+    std::string_view fileStringView((const char*)fileData.data(), fileData.size());
     ParseSection currentSection = ParseSection::NONE;
     StringUtils::forEachLine(fileStringView, [&data, &currentSection] (std::string_view line) {
         line = StringUtils::eraseOneLineComment(line);
@@ -1,5 +1,20 @@
 #include "DialogTests.h"
 
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <cassert>
+#include <format>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+
+#include "parsers/CS_Parser.h"
+#include "utils/ThreadPool.h"
+#include "utils/TracyProfiler.h"
+#include "utils/DebugLog.h"
+#include "CsExecutor.h"
+
 std::unordered_map<std::string, std::vector<DialogInstruction> > getManualDialogTestData()
 {
     std::unordered_map<std::string, std::vector<DialogInstruction>> manualCases = {
@@ -47,3 +62,269 @@ std::unordered_map<std::string, std::vector<DialogInstruction> > getManualDialog
     };
     return manualCases;
 }
+
+namespace {
+
+void runManualDialogTest(CsExecutor& executor, const std::vector<DialogInstruction>& instructions)
+{
+    for (const auto& inst : instructions) {
+        switch (inst.inst) {
+            case kExec: {
+                while (executor.next());
+                break;
+            }
+
+            case kUserInputAndExec: {
+                assert(executor.currentStatus() == CsExecutor::kWaitUser);
+                executor.userInput(inst.value);
+                while (executor.next());
+                break;
+            }
+
+            case kSetVariable: {
+                if (auto it = executor.scriptVars().find(inst.text); it != executor.scriptVars().end()) {
+                    it->second = inst.value;
+                } else {
+                    LogFmt("kSetVariable variable '{}' not found", inst.text);
+                }
+                break;
+            }
+
+            case kSoftRestart: {
+                executor.restart(false);
+                break;
+            }
+
+            case kHardRestart: {
+                executor.restart(true);
+                break;
+            }
+        }
+    }
+}
+
+struct StateKeyHash {
+    size_t operator()(const CsExecutor::StateKey& key) const { return key.hash(); }
+};
+
+} // namespace
+
+DialogExploreResult exploreDialog(CsExecutor& executor, size_t maxStates)
+{
+    Tracy_ZoneScoped;
+
+    // answer == 0 - повторный запуск после конца диалога
+    struct Branch {
+        CsExecutor::State state;
+        int nextAnswer = 0;
+        int lastAnswer = 0;
+        bool isCurrent = true; // executor уже находится в этом состоянии
+    };
+
+    DialogExploreResult result;
+    std::unordered_set<CsExecutor::StateKey, StateKeyHash> visited;
+    std::vector<Branch> branches;
+
+    auto runToStop = [&] () {
+        while (executor.next()) {}
+
+        const CsExecutor::ExecuteStatus status = executor.currentStatus();
+        if (status == CsExecutor::kInfinity) {
+            result.infinityPaths++;
+            return;
+        }
+        if (status != CsExecutor::kWaitUser && status != CsExecutor::kEnd) {
+            return;
+        }
+        if (visited.size() >= maxStates) {
+            result.isLimitReached = true;
+            return;
+        }
+        if (!visited.insert(executor.stateKey()).second) {
+            result.skippedStates++;
+            return;
+        }
+        result.states++;
+
+        if (status == CsExecutor::kEnd) {
+            branches.push_back({executor.saveState(), 0, 0});
+        } else if (int answersCount = executor.dialogsAnswersCount(); answersCount > 0) {
+            branches.push_back({executor.saveState(), 1, answersCount});
+        }
+    };
+
+    runToStop();
+    while (!branches.empty() && !result.isLimitReached) {
+        Branch& branch = branches.back();
+        if (!branch.isCurrent) {
+            executor.restoreState(branch.state);
+        }
+        branch.isCurrent = false;
+
+        const int answer = branch.nextAnswer++;
+        if (answer == branch.lastAnswer) {
+            branches.pop_back();
+        }
+
+        if (answer == 0) {
+            executor.restart(false);
+        } else {
+            executor.userInput(static_cast<uint8_t>(answer));
+        }
+        runToStop();
+    }
+    return result;
+}
+
+DialogTestResult runDialogTest(std::string_view rootDirectory,
+                               const std::string& csFile,
+                               const StringHashTable<AgeVariable_t>& globalVars,
+                               const std::vector<DialogInstruction>* manualCase)
+{
+    std::string csError;
+    CS_Data csData;
+
+    std::string csPath = std::format("{}/{}", rootDirectory, csFile);
+    if (!CS_Parser::parse(csPath, csData, &csError)) {
+        LogFmt("CS_Parser error: {}", csError);
+        return {csFile, "IncorrectFormat", csError, 100.0f};
+    }
+
+    try {
+        CsExecutor executor(csData.nodes, globalVars);
+        if (manualCase) {
+            runManualDialogTest(executor, *manualCase);
+
+            // Покрытие ручного сценария дополняется обходом того же скрипта
+            try {
+                CsExecutor exploreExecutor(csData.nodes, globalVars);
+                exploreDialog(exploreExecutor);
+                executor.mergeCoverage(exploreExecutor.coverage());
+            } catch (const std::exception& ex) {
+                LogFmt("Explore dialog error: {}", ex.what());
+            }
+            return {csFile, executor.currentStatusString(), {}, executor.executedPercent(),
+                    executor.coverage().count(), csData.nodes.size()};
+        }
+
+        // Обход, остановленный лимитом, не доказывает, что непройденные узлы недостижимы
+        DialogExploreResult exploreResult = exploreDialog(executor);
+        if (exploreResult.isLimitReached) {
+            return {csFile, "LimitReached", std::format("Explored states limit reached: {}", exploreResult.states),
+                    executor.executedPercent(), executor.coverage().count(), csData.nodes.size()};
+        }
+        const char* status = exploreResult.infinityPaths ? "Infinity" : "End";
+        return {csFile, status, {}, executor.executedPercent(),
+                executor.coverage().count(), csData.nodes.size()};
+    } catch (const std::exception& ex) {
+        return {csFile, "FatalError", ex.what(), 0.0f, 0, csData.nodes.size()};
+    }
+}
+
+struct DialogTestRunner::Job {
+    Job(std::string rootDirectory, std::vector<std::string> csFiles, std::shared_ptr<const StringHashTable<AgeVariable_t>> globalVars) :
+        rootDirectory(std::move(rootDirectory)),
+        csFiles(std::move(csFiles)),
+        globalVars(globalVars ? std::move(globalVars) : std::make_shared<const StringHashTable<AgeVariable_t>>())
+    {}
+
+    std::string rootDirectory;
+    std::vector<std::string> csFiles;
+    const std::shared_ptr<const StringHashTable<AgeVariable_t>> globalVars;
+    const std::unordered_map<std::string, std::vector<DialogInstruction>> manualCases = getManualDialogTestData();
+
+    std::atomic<size_t> nextFile = 0;
+    std::atomic<size_t> processed = 0;
+    std::atomic<bool> isCanceled = false;
+
+    std::mutex mutex;
+    std::vector<DialogTestResult> ready; // Под mutex
+
+    void run() {
+        while (!isCanceled.load(std::memory_order_relaxed)) {
+            const size_t fileIndex = nextFile.fetch_add(1, std::memory_order_relaxed);
+            if (fileIndex >= csFiles.size())
+                break;
+
+            const std::string& csFile = csFiles[fileIndex];
+            auto it = manualCases.find(csFile);
+            DialogTestResult result = runDialogTest(rootDirectory, csFile, *globalVars,
+                                                    it != manualCases.end() ? &it->second : nullptr);
+            {
+                std::lock_guard lock(mutex);
+                ready.push_back(std::move(result));
+            }
+            processed.fetch_add(1, std::memory_order_release);
+        }
+    }
+};
+
+DialogTestRunner::DialogTestRunner() noexcept {}
+
+DialogTestRunner::~DialogTestRunner()
+{
+    cancel();
+}
+
+void DialogTestRunner::start(std::string_view rootDirectory,
+                             std::vector<std::string> csFiles,
+                             std::shared_ptr<const StringHashTable<AgeVariable_t>> globalVars,
+                             unsigned threadCount)
+{
+    cancel();
+
+    m_job = std::make_shared<Job>(std::string(rootDirectory), std::move(csFiles), std::move(globalVars));
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min<unsigned>(threadCount, std::max<size_t>(1, m_job->csFiles.size()));
+    if (!m_pool || m_pool->threadCount() != threadCount) {
+        m_pool = std::make_unique<ThreadPool>(threadCount);
+    }
+
+    for (unsigned i = 0; i < threadCount; ++i) {
+        m_workers.push_back(m_pool->submit([job = m_job] { job->run(); }));
+    }
+}
+
+void DialogTestRunner::cancel()
+{
+    if (m_job) {
+        m_job->isCanceled = true;
+    }
+    wait();
+}
+
+void DialogTestRunner::wait()
+{
+    for (std::future<void>& worker : m_workers) {
+        worker.wait();
+    }
+    m_workers.clear();
+}
+
+size_t DialogTestRunner::takeResults(std::vector<DialogTestResult>& results)
+{
+    if (!m_job) return 0;
+
+    std::lock_guard lock(m_job->mutex);
+    const size_t count = m_job->ready.size();
+    std::move(m_job->ready.begin(), m_job->ready.end(), std::back_inserter(results));
+    m_job->ready.clear();
+    return count;
+}
+
+bool DialogTestRunner::isRunning() const
+{
+    return m_job && !m_job->isCanceled && processedCount() < totalCount();
+}
+
+size_t DialogTestRunner::processedCount() const
+{
+    return m_job ? m_job->processed.load(std::memory_order_acquire) : 0;
+}
+
+size_t DialogTestRunner::totalCount() const
+{
+    return m_job ? m_job->csFiles.size() : 0;
+}
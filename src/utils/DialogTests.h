@@ -1,6 +1,14 @@
 #pragma once
 #include <unordered_map>
+#include <string_view>
+#include <future>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include "Types.h"
+
+class ThreadPool;
 
 enum Instruction {
     kExec,
@@ -18,3 +26,70 @@ struct DialogInstruction {
 
 std::unordered_map<std::string, std::vector<DialogInstruction>> getManualDialogTestData();
 
+struct DialogTestResult {
+    std::string filepath;
+    std::string status;
+    std::string errorMessage;
+    float percent = 0.0f;
+    size_t coveredNodes = 0;
+    size_t totalNodes = 0;
+};
+
+class CsExecutor;
+
+struct DialogExploreResult {
+    size_t states = 0;        // Уникальные состояния: ожидание ответа или конец диалога
+    size_t skippedStates = 0; // Повторы уже пройденных состояний
+    size_t infinityPaths = 0; // Пути, оборванные защитой от бесконечного выполнения
+    bool isLimitReached = false;
+};
+
+// Обход в глубину всех вариантов ответа. В каждой развилке сохраняется снимок CsExecutor,
+// следующий ответ выбирается после восстановления снимка, без повторного прохода от restart.
+// Уже пройденные состояния (CsExecutor::StateKey) отсекаются, сравниваются состояния целиком, а не только хэш.
+// При maxStates уникальных состояний обход прекращается (isLimitReached).
+// После конца диалога он запускается заново (restart(false)): изменившиеся переменные открывают новые пути
+DialogExploreResult exploreDialog(CsExecutor& executor, size_t maxStates = 10000);
+
+// Тест одного скрипта: ручной сценарий (если есть) и обход всех ответов, покрытие объединяется.
+// Статус LimitReached - обход остановлен лимитом состояний и покрытие может быть неполным
+DialogTestResult runDialogTest(std::string_view rootDirectory,
+                               const std::string& csFile,
+                               const StringHashTable<AgeVariable_t>& globalVars,
+                               const std::vector<DialogInstruction>* manualCase);
+
+// Тест всех скриптов в собственном пуле потоков. Каждый поток забирает следующий ещё не взятый файл,
+// поэтому длинные скрипты не задерживают остальные. У каждого потока свой CsExecutor,
+// таблица глобальных переменных не копируется: она общая с вызывающим и не меняется.
+// Результаты забираются через takeResults по мере готовности, в порядке завершения
+class DialogTestRunner
+{
+public:
+    DialogTestRunner() noexcept;
+    ~DialogTestRunner();
+
+    DialogTestRunner(const DialogTestRunner&) = delete;
+    DialogTestRunner& operator=(const DialogTestRunner&) = delete;
+
+    // Предыдущий прогон отменяется. threadCount == 0 - по числу ядер
+    void start(std::string_view rootDirectory,
+               std::vector<std::string> csFiles,
+               std::shared_ptr<const StringHashTable<AgeVariable_t>> globalVars,
+               unsigned threadCount = 0);
+    void cancel();
+    void wait();
+
+    // Добавляет в results результаты, готовые с прошлого вызова. Возвращает их количество
+    size_t takeResults(std::vector<DialogTestResult>& results);
+
+    bool isRunning() const;
+    size_t processedCount() const;
+    size_t totalCount() const;
+
+private:
+    struct Job;
+
+    std::shared_ptr<Job> m_job;
+    std::unique_ptr<ThreadPool> m_pool;
+    std::vector<std::future<void>> m_workers;
+};
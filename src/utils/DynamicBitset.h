@@ -0,0 +1,68 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <bit>
+
+// Битовое множество с размером, известным только во время выполнения.
+// Количество установленных битов хранится и обновляется при set, поэтому count() ничего не стоит
+class DynamicBitset
+{
+public:
+    DynamicBitset() = default;
+    explicit DynamicBitset(size_t size) { resize(size); }
+
+    void resize(size_t size) {
+        m_size = size;
+        m_words.assign((size + kWordBits - 1) / kWordBits, 0);
+        m_count = 0;
+    }
+
+    // true, если бит раньше не был установлен
+    bool set(size_t index) noexcept {
+        assert(index < m_size);
+        uint64_t& word = m_words[index / kWordBits];
+        const uint64_t mask = uint64_t(1) << (index % kWordBits);
+        if (word & mask)
+            return false;
+        word |= mask;
+        ++m_count;
+        return true;
+    }
+
+    bool test(size_t index) const noexcept {
+        assert(index < m_size);
+        return (m_words[index / kWordBits] >> (index % kWordBits)) & 1;
+    }
+
+    // Объединение с множеством того же размера
+    void merge(const DynamicBitset& other) noexcept {
+        assert(other.m_size == m_size);
+        m_count = 0;
+        for (size_t i = 0; i < m_words.size(); ++i) {
+            m_words[i] |= other.m_words[i];
+            m_count += std::popcount(m_words[i]);
+        }
+    }
+
+    void clear() noexcept {
+        std::fill(m_words.begin(), m_words.end(), 0);
+        m_count = 0;
+    }
+
+    size_t size() const noexcept { return m_size; }
+    size_t count() const noexcept { return m_count; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    bool operator==(const DynamicBitset& other) const noexcept {
+        return m_size == other.m_size && m_words == other.m_words;
+    }
+
+private:
+    static constexpr size_t kWordBits = 64;
+
+    std::vector<uint64_t> m_words;
+    size_t m_size = 0;
+    size_t m_count = 0;
+};
@@ -25,6 +25,53 @@
   #include <shlobj.h>
 #endif
 
+#ifdef __linux__
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <cerrno>
+#endif
+
+MappedFile::~MappedFile() noexcept
+{
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        m_isMapped = other.m_isMapped;
+        m_buffer = std::move(other.m_buffer);
+        m_data = m_isMapped ? other.m_data : m_buffer.data();
+        m_size = other.m_size;
+
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_isMapped = false;
+    }
+    return *this;
+}
+
+void MappedFile::unmap() noexcept
+{
+#ifdef __linux__
+    if (m_isMapped && m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_isMapped = false;
+    m_buffer.clear();
+}
+
 std::vector<uint8_t> FileUtils::loadFile(std::string_view filePath, std::string* error)
 {
     // SDL_LoadFile не используется чтобы избежать копирования памяти в вектор
@@ -76,6 +123,46 @@ std::vector<uint8_t> FileUtils::loadFile(std::string_view filePath, std::string*
     return result;
 }
 
+MappedFile FileUtils::mapFile(std::string_view filePath, std::string* error)
+{
+    Tracy_ZoneScoped;
+    MappedFile result;
+
+#ifdef __linux__
+    int fd = open(std::string(filePath).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd != -1) {
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode)) {
+            if (fileStat.st_size == 0) {
+                close(fd);
+                if (error)
+                    *error = "Empty file";
+                return result;
+            }
+
+            void* address = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                // Парсеры читают файлы последовательно от начала до конца
+                madvise(address, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+                close(fd);
+                result.m_data = static_cast<const uint8_t*>(address);
+                result.m_size = (size_t)fileStat.st_size;
+                result.m_isMapped = true;
+                return result;
+            }
+            LogFmt("mmap failed for {}: {}. Fallback to read", filePath, std::strerror(errno));
+        }
+        close(fd);
+    }
+#endif
+
+    // Запасной вариант: обычное чтение (и текст ошибки от SDL)
+    result.m_buffer = loadFile(filePath, error);
+    result.m_data = result.m_buffer.data();
+    result.m_size = result.m_buffer.size();
+    return result;
+}
+
 bool FileUtils::saveFile(std::string_view filePath, std::span<const uint8_t> fileData, std::string* error)
 {
     Tracy_ZoneScoped;
@@ -5,12 +5,43 @@
 #include <vector>
 #include <span>
 
+// Содержимое файла только для чтения. Отображение в память (mmap), либо обычное чтение в буфер
+class MappedFile
+{
+public:
+    MappedFile() noexcept = default;
+    ~MappedFile() noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    std::span<const uint8_t> data() const noexcept { return {m_data, m_size}; }
+    size_t size() const noexcept { return m_size; }
+
+    bool isMapped() const noexcept { return m_isMapped; }
+    explicit operator bool() const noexcept { return m_size > 0; }
+
+private:
+    friend class FileUtils;
+
+    void unmap() noexcept;
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_isMapped = false;
+    std::vector<uint8_t> m_buffer; // Если отображение недоступно
+};
+
 class FileUtils
 {
 public:
     FileUtils() = delete;
 
     static std::vector<uint8_t> loadFile(std::string_view filePath, std::string* error = nullptr);
+    static MappedFile mapFile(std::string_view filePath, std::string* error = nullptr); // Пустой файл считается ошибкой, как и в loadFile
     static bool saveFile(std::string_view filePath, std::span<const uint8_t> fileData, std::string* error = nullptr);
 
     static std::vector<uint8_t> loadJpegPhotoshopThumbnail(std::string_view filePath, std::string* error = nullptr);
@@ -28,7 +28,7 @@ bool ImGuiWidgets::ComboBoxWithIndex(std::string_view label, const std::vector<s
     return changed;
 }
 
-void ImGuiWidgets::Loader(std::string_view label, bool& showWindow)
+void ImGuiWidgets::Loader(std::string_view label, bool& showWindow, float progress)
 {
     ImGuiIO& io = ImGui::GetIO();
     auto title = "Loading";
@@ -43,7 +43,8 @@ void ImGuiWidgets::Loader(std::string_view label, bool& showWindow)
                                                    ImGuiWindowFlags_NoInputs |
                                                    ImGuiWindowFlags_NoNav))
     {
-        ImGui::ProgressBar(-0.75f * (float)ImGui::GetTime(), ImVec2(0.0f, 0.0f), label.data());
+        float fraction = (progress < 0.0f) ? -0.75f * (float)ImGui::GetTime() : progress;
+        ImGui::ProgressBar(fraction, ImVec2(0.0f, 0.0f), label.data());
         ImGui::EndPopup();
     }
 }
@@ -12,7 +12,7 @@ public:
     ImGuiWidgets() = delete;
 
     static bool ComboBoxWithIndex(std::string_view label, const std::vector<std::string>& items, int& selectedIndex);
-    static void Loader(std::string_view label, bool& showWindow);
+    static void Loader(std::string_view label, bool& showWindow, float progress = -1.0f); // progress < 0 - неопределённый
     static void ShowMessageModal(std::string_view title, std::string& message);
     static bool ShowMessageModalEx(std::string_view title, const std::function<void()>& callback);
 
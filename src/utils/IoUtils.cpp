@@ -74,6 +74,20 @@ int32_t readInt32(std::span<const uint8_t> fileData, size_t& offset) {
     return result;
 }
 
+uint64_t readUInt64(std::span<const uint8_t> fileData, size_t& offset) {
+    uint64_t result;
+    std::memcpy(&result, &fileData[offset], sizeof(uint64_t));
+    offset += sizeof(uint64_t);
+    return result;
+}
+
+int64_t readInt64(std::span<const uint8_t> fileData, size_t& offset) {
+    int64_t result;
+    std::memcpy(&result, &fileData[offset], sizeof(int64_t));
+    offset += sizeof(int64_t);
+    return result;
+}
+
 float readFloat(std::span<const uint8_t> fileData, size_t& offset) {
     float result = *reinterpret_cast<const float*>(&fileData[offset]);
     offset += sizeof(float);
@@ -128,6 +142,20 @@ void writeInt32(std::vector<uint8_t>& buffer, int32_t value)
     buffer.insert(buffer.end(), bytes, bytes + 4);
 }
 
+void writeUInt64(std::vector<uint8_t>& buffer, uint64_t value)
+{
+    uint8_t bytes[8];
+    std::memcpy(bytes, &value, sizeof(uint64_t));
+    buffer.insert(buffer.end(), bytes, bytes + 8);
+}
+
+void writeInt64(std::vector<uint8_t>& buffer, int64_t value)
+{
+    uint8_t bytes[8];
+    std::memcpy(bytes, &value, sizeof(int64_t));
+    buffer.insert(buffer.end(), bytes, bytes + 8);
+}
+
 void writeFloat(std::vector<uint8_t>& buffer, float value) {
     uint8_t bytes[4];
     std::memcpy(bytes, &value, sizeof(float));
@@ -1,8 +1,16 @@
 #pragma once
+#include <type_traits>
 #include <string_view>
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <utility>
 #include <vector>
+#include <array>
+#include <tuple>
 #include <span>
+#include <bit>
 
 namespace IoUtils
 {
@@ -13,6 +21,8 @@ namespace IoUtils
     uint32_t readUInt32(std::span<const uint8_t> fileData, size_t& offset);
     int16_t readInt16(std::span<const uint8_t> fileData, size_t& offset);
     int32_t readInt32(std::span<const uint8_t> fileData, size_t& offset);
+    uint64_t readUInt64(std::span<const uint8_t> fileData, size_t& offset);
+    int64_t readInt64(std::span<const uint8_t> fileData, size_t& offset);
     float readFloat(std::span<const uint8_t> fileData, size_t& offset);
     double readDouble(std::span<const uint8_t> fileData, size_t& offset);
 
@@ -23,6 +33,94 @@ namespace IoUtils
     void writeUInt32(std::vector<uint8_t>& buffer, uint32_t value);
     void writeInt16(std::vector<uint8_t>& buffer, int16_t value);
     void writeInt32(std::vector<uint8_t>& buffer, int32_t value);
+    void writeUInt64(std::vector<uint8_t>& buffer, uint64_t value);
+    void writeInt64(std::vector<uint8_t>& buffer, int64_t value);
     void writeFloat(std::vector<uint8_t>& buffer, float value);
     void writeDouble(std::vector<uint8_t>& buffer, double value);
+
+    // Значение в порядке байт файлов игры (little-endian). Перестановка байт выбирается при компиляции
+    template<class T>
+    T decodeValue(const uint8_t* data) noexcept {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1) {
+            auto bytes = std::bit_cast<std::array<uint8_t, sizeof(T)>>(value);
+            std::reverse(bytes.begin(), bytes.end());
+            value = std::bit_cast<T>(bytes);
+        }
+        return value;
+    }
+
+    // Запись фиксированного размера: типы полей в порядке следования в файле, без выравнивания.
+    // Смещения полей вычисляются при компиляции
+    template<class... Fields>
+    struct RecordLayout {
+        using Values = std::tuple<Fields...>;
+        static constexpr size_t kSize = (sizeof(Fields) + ...);
+
+        static Values decode(const uint8_t* data) noexcept {
+            return decodeFields(data, std::index_sequence_for<Fields...>{});
+        }
+
+    private:
+        static constexpr std::array<size_t, sizeof...(Fields)> kOffsets = [] {
+            std::array<size_t, sizeof...(Fields)> offsets{};
+            size_t offset = 0;
+            size_t index = 0;
+            ((offsets[index++] = offset, offset += sizeof(Fields)), ...);
+            return offsets;
+        }();
+
+        template<size_t... Index>
+        static Values decodeFields(const uint8_t* data, std::index_sequence<Index...>) noexcept {
+            return Values(decodeValue<Fields>(data + kOffsets[Index])...);
+        }
+    };
+
+    template<class Layout>
+    bool hasRecords(std::span<const uint8_t> fileData, size_t offset, size_t count) noexcept {
+        return offset <= fileData.size() && (fileData.size() - offset) / Layout::kSize >= count;
+    }
+
+    // Одна запись. Выход за границы проверяется assert, как в readUInt32 и остальных
+    template<class Layout>
+    typename Layout::Values readRecord(std::span<const uint8_t> fileData, size_t& offset) {
+        assert(hasRecords<Layout>(fileData, offset, 1));
+        typename Layout::Values values = Layout::decode(fileData.data() + offset);
+        offset += Layout::kSize;
+        return values;
+    }
+
+    // Поля записи передаются в конструктор (или агрегатную инициализацию) T
+    template<class Layout, class T>
+    T readRecord(std::span<const uint8_t> fileData, size_t& offset) {
+        return std::make_from_tuple<T>(readRecord<Layout>(fileData, offset));
+    }
+
+    // Массив из count записей: одна проверка границ на весь массив, затем callback(поля...) для каждой записи.
+    // Если данных не хватает, возвращает false и не меняет offset
+    template<class Layout, class Callback>
+    bool forEachRecord(std::span<const uint8_t> fileData, size_t& offset, size_t count, Callback&& callback) {
+        if (!hasRecords<Layout>(fileData, offset, count))
+            return false;
+
+        const uint8_t* record = fileData.data() + offset;
+        for (size_t i = 0; i < count; ++i, record += Layout::kSize) {
+            std::apply(callback, Layout::decode(record));
+        }
+        offset += count * Layout::kSize;
+        return true;
+    }
+
+    template<class Layout, class T>
+    bool readRecords(std::span<const uint8_t> fileData, size_t& offset, size_t count, std::vector<T>& output) {
+        if (!hasRecords<Layout>(fileData, offset, count))
+            return false;
+
+        output.reserve(output.size() + count);
+        return forEachRecord<Layout>(fileData, offset, count, [&output] (auto... values) {
+            output.emplace_back(values...);
+        });
+    }
 }
@@ -4,6 +4,7 @@
 // Usage:
 // BX_ARCH_NAME
 // BX_COMPILER_NAME
+// BX_SIMD_AVX2, BX_SIMD_SSE2, BX_SIMD_NEON
 
 #define BX_STRINGIZE(_x) BX_STRINGIZE_(_x)
 #define BX_STRINGIZE_(_x) #_x
@@ -80,3 +81,24 @@
 #elif BX_ARCH_64BIT
 #	define BX_ARCH_NAME "64-bit"
 #endif // BX_ARCH_
+
+// SIMD
+#define BX_SIMD_AVX2 0
+#define BX_SIMD_SSE2 0
+#define BX_SIMD_NEON 0
+
+#if defined(__AVX2__)
+#	undef  BX_SIMD_AVX2
+#	define BX_SIMD_AVX2 1
+#endif // __AVX2__
+
+#if defined(__SSE2__)                           \
+ || defined(_M_X64)                             \
+ || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	undef  BX_SIMD_SSE2
+#	define BX_SIMD_SSE2 1
+#elif defined(__ARM_NEON)   \
+ ||   defined(_M_ARM64)
+#	undef  BX_SIMD_NEON
+#	define BX_SIMD_NEON 1
+#endif // BX_SIMD_
@@ -0,0 +1,47 @@
+#pragma once
+#include <memory>
+#include <atomic>
+
+// Значение, которое фоновый поток публикует целиком, а поток UI забирает в начале кадра.
+// Два буфера: опубликованный (атомарно заменяется при publish) и текущий (меняется только в acquire).
+// Ссылка из get() остаётся действительной до следующего acquire() или reset(), даже если фоновый поток уже
+// опубликовал новое значение
+template<class T>
+class Snapshot
+{
+public:
+    // Любой поток
+    void publish(T value) {
+        m_published.store(std::make_shared<const T>(std::move(value)), std::memory_order_release);
+    }
+
+    // Поток UI. true, если появилось новое значение
+    bool acquire() noexcept {
+        std::shared_ptr<const T> published = m_published.load(std::memory_order_acquire);
+        if (published == m_current)
+            return false;
+        m_current = std::move(published);
+        return true;
+    }
+
+    // Поток UI. Пустое значение, пока ничего не опубликовано
+    const T& get() const noexcept {
+        static const T kEmpty{};
+        return m_current ? *m_current : kEmpty;
+    }
+
+    // Поток UI. Текущее значение для других потоков: не меняется и живёт, пока на него есть указатели
+    std::shared_ptr<const T> share() const noexcept { return m_current; }
+
+    bool isReady() const noexcept { return m_current != nullptr; }
+
+    // Поток UI, когда фоновый поток ничего не публикует
+    void reset() noexcept {
+        m_published.store(nullptr, std::memory_order_release);
+        m_current.reset();
+    }
+
+private:
+    std::atomic<std::shared_ptr<const T>> m_published;
+    std::shared_ptr<const T> m_current;
+};
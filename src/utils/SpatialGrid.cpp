@@ -0,0 +1,127 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "utils/TracyProfiler.h"
+
+void SpatialGrid::build(std::span<const Rect> rects, float cellSize)
+{
+    Tracy_ZoneScoped;
+    clear();
+    m_rects.assign(rects.begin(), rects.end());
+    m_cellSize = cellSize;
+
+    bool hasBounds = false;
+    Rect bounds;
+    for (const Rect& rect : m_rects) {
+        if (rect.minX >= rect.maxX || rect.minY >= rect.maxY) continue;
+
+        if (!hasBounds) {
+            bounds = rect;
+            hasBounds = true;
+        } else {
+            bounds.minX = std::min(bounds.minX, rect.minX);
+            bounds.minY = std::min(bounds.minY, rect.minY);
+            bounds.maxX = std::max(bounds.maxX, rect.maxX);
+            bounds.maxY = std::max(bounds.maxY, rect.maxY);
+        }
+    }
+    if (!hasBounds) return;
+
+    m_originX = bounds.minX;
+    m_originY = bounds.minY;
+    m_columns = std::max(1, static_cast<int>(std::ceil((bounds.maxX - bounds.minX) / m_cellSize)));
+    m_rows = std::max(1, static_cast<int>(std::ceil((bounds.maxY - bounds.minY) / m_cellSize)));
+
+    // Два прохода: подсчёт объектов в ячейках, затем раскладка по спискам
+    m_cellStarts.assign((size_t)m_columns * m_rows + 1, 0);
+    auto forEachCell = [this] (const Rect& rect, auto&& callback) {
+        const int lastColumn = cellColumn(std::nextafter(rect.maxX, rect.minX));
+        const int lastRow = cellRow(std::nextafter(rect.maxY, rect.minY));
+        for (int row = cellRow(rect.minY); row <= lastRow; ++row) {
+            for (int column = cellColumn(rect.minX); column <= lastColumn; ++column) {
+                callback((size_t)row * m_columns + column);
+            }
+        }
+    };
+
+    for (const Rect& rect : m_rects) {
+        if (rect.minX >= rect.maxX || rect.minY >= rect.maxY) continue;
+        forEachCell(rect, [this] (size_t cell) { ++m_cellStarts[cell + 1]; });
+    }
+    for (size_t cell = 1; cell < m_cellStarts.size(); ++cell) {
+        m_cellStarts[cell] += m_cellStarts[cell - 1];
+    }
+
+    m_cellItems.resize(m_cellStarts.back());
+    std::vector<uint32_t> cellFill(m_cellStarts.begin(), m_cellStarts.end() - 1);
+    for (uint32_t index = 0; index < m_rects.size(); ++index) {
+        const Rect& rect = m_rects[index];
+        if (rect.minX >= rect.maxX || rect.minY >= rect.maxY) continue;
+        forEachCell(rect, [&] (size_t cell) { m_cellItems[cellFill[cell]++] = index; });
+    }
+}
+
+void SpatialGrid::clear()
+{
+    m_rects.clear();
+    m_cellStarts.clear();
+    m_cellItems.clear();
+    m_columns = 0;
+    m_rows = 0;
+}
+
+void SpatialGrid::query(const Rect& rect, std::vector<uint32_t>& result) const
+{
+    if (m_cellItems.empty()) return;
+
+    const size_t firstResult = result.size();
+    const int firstColumn = cellColumn(rect.minX);
+    const int lastColumn = cellColumn(rect.maxX);
+    const int firstRow = cellRow(rect.minY);
+    const int lastRow = cellRow(rect.maxY);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const size_t cell = (size_t)row * m_columns + column;
+            for (uint32_t i = m_cellStarts[cell]; i < m_cellStarts[cell + 1]; ++i) {
+                const uint32_t index = m_cellItems[i];
+                if (m_rects[index].overlaps(rect)) {
+                    result.push_back(index);
+                }
+            }
+        }
+    }
+
+    // Объект из нескольких ячеек попадает в результат несколько раз
+    auto begin = result.begin() + firstResult;
+    std::sort(begin, result.end());
+    result.erase(std::unique(begin, result.end()), result.end());
+}
+
+void SpatialGrid::queryPoint(float x, float y, std::vector<uint32_t>& result) const
+{
+    if (m_cellItems.empty()) return;
+    if (x < m_originX || y < m_originY ||
+        x >= m_originX + m_columns * m_cellSize || y >= m_originY + m_rows * m_cellSize) return;
+
+    // Внутри одной ячейки индексы идут по возрастанию, сортировка не нужна
+    const size_t cell = (size_t)cellRow(y) * m_columns + cellColumn(x);
+    for (uint32_t i = m_cellStarts[cell]; i < m_cellStarts[cell + 1]; ++i) {
+        const uint32_t index = m_cellItems[i];
+        const Rect& rect = m_rects[index];
+        if (x >= rect.minX && x < rect.maxX && y >= rect.minY && y < rect.maxY) {
+            result.push_back(index);
+        }
+    }
+}
+
+int SpatialGrid::cellColumn(float x) const
+{
+    return std::clamp(static_cast<int>(std::floor((x - m_originX) / m_cellSize)), 0, m_columns - 1);
+}
+
+int SpatialGrid::cellRow(float y) const
+{
+    return std::clamp(static_cast<int>(std::floor((y - m_originY) / m_cellSize)), 0, m_rows - 1);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <span>
+
+// Равномерная сетка над прямоугольниками объектов.
+// Объект записан во все ячейки, которые задевает его прямоугольник, запрос перебирает только ячейки под
+// прямоугольником запроса. Индексы объектов совпадают с порядком прямоугольников при build
+class SpatialGrid
+{
+public:
+    struct Rect {
+        float minX = 0.0f;
+        float minY = 0.0f;
+        float maxX = 0.0f;
+        float maxY = 0.0f;
+
+        bool overlaps(const Rect& other) const {
+            return minX < other.maxX && other.minX < maxX &&
+                   minY < other.maxY && other.minY < maxY;
+        }
+    };
+
+    static constexpr float kDefaultCellSize = 256.0f;
+
+    // Сетка покрывает объединение всех прямоугольников, пустые прямоугольники не индексируются
+    void build(std::span<const Rect> rects, float cellSize = kDefaultCellSize);
+    void clear();
+
+    // Индексы объектов, пересекающих rect, по возрастанию и без повторов. Результат дописывается в result
+    void query(const Rect& rect, std::vector<uint32_t>& result) const;
+    // Индексы объектов, содержащих точку
+    void queryPoint(float x, float y, std::vector<uint32_t>& result) const;
+
+    size_t size() const { return m_rects.size(); }
+    const Rect& rect(uint32_t index) const { return m_rects[index]; }
+
+private:
+    int cellColumn(float x) const;
+    int cellRow(float y) const;
+
+    std::vector<Rect> m_rects;
+    std::vector<uint32_t> m_cellStarts; // Начала списков ячеек в m_cellItems, ячеек + 1
+    std::vector<uint32_t> m_cellItems;
+    float m_originX = 0.0f;
+    float m_originY = 0.0f;
+    float m_cellSize = kDefaultCellSize;
+    int m_columns = 0;
+    int m_rows = 0;
+};
@@ -5,6 +5,14 @@
 #include <charconv>
 #include <cstring>
 #include <cassert>
+#include <array>
+#include <bit>
+
+#if BX_SIMD_AVX2 || BX_SIMD_SSE2
+  #include <immintrin.h>
+#elif BX_SIMD_NEON
+  #include <arm_neon.h>
+#endif
 
 using namespace std::literals::string_view_literals;
 
@@ -28,7 +36,7 @@ static constexpr std::string_view win1251_to_utf8[] = {
     " "sv, "!"sv, "\""sv, "#"sv, "$"sv, "%"sv, "&"sv, "'"sv, "("sv, ")"sv, "*"sv, "+"sv, ","sv, "-"sv, "."sv, "/"sv,   // 0x20 - 0x2F
     "0"sv, "1"sv, "2"sv, "3"sv, "4"sv, "5"sv, "6"sv, "7"sv, "8"sv, "9"sv, ":"sv, ";"sv, "<"sv, "="sv, ">"sv, "?"sv,    // 0x30 - 0x3F
     "@"sv, "A"sv, "B"sv, "C"sv, "D"sv, "E"sv, "F"sv, "G"sv, "H"sv, "I"sv, "J"sv, "K"sv, "L"sv, "M"sv, "N"sv, "O"sv,    // 0x40 - 0x4F
-    "P"sv, "Q"sv, "R"sv, "S"sv, "T"sv, "U"sv, "V"sv, "W"sv, "X"sv, "Y"sv, "Z"sv, "["sv, "\\sv", "]"sv, "^"sv, "_"sv,   // 0x50 - 0x5F
+    "P"sv, "Q"sv, "R"sv, "S"sv, "T"sv, "U"sv, "V"sv, "W"sv, "X"sv, "Y"sv, "Z"sv, "["sv, "\\"sv, "]"sv, "^"sv, "_"sv,   // 0x50 - 0x5F
     "`"sv, "a"sv, "b"sv, "c"sv, "d"sv, "e"sv, "f"sv, "g"sv, "h"sv, "i"sv, "j"sv, "k"sv, "l"sv, "m"sv, "n"sv, "o"sv,    // 0x60 - 0x6F
     "p"sv, "q"sv, "r"sv, "s"sv, "t"sv, "u"sv, "v"sv, "w"sv, "x"sv, "y"sv, "z"sv, "{"sv, "|"sv, "}"sv, "~"sv, "\x7F"sv, // 0x70 - 0x7F
 
@@ -42,6 +50,80 @@ static constexpr std::string_view win1251_to_utf8[] = {
     "р"sv, "с"sv, "т"sv, "у"sv, "ф"sv, "х"sv, "ц"sv, "ч"sv, "ш"sv, "щ"sv, "ъ"sv, "ы"sv, "ь"sv, "э"sv, "ю"sv, "я"sv,    // 0xF0 - 0xFF
 };
 
+// Верхняя половина таблицы в виде записей фиксированного размера (для записи одним memcpy)
+struct Utf8Sequence {
+    char bytes[3];
+    uint8_t size;
+};
+static_assert(sizeof(Utf8Sequence) == 4);
+
+static constexpr size_t kMaxUtf8PerWin1251Char = 3;
+
+static constexpr std::array<Utf8Sequence, 128> win1251HighToUtf8 = [] {
+    std::array<Utf8Sequence, 128> result{};
+    for (size_t i = 0; i < result.size(); ++i) {
+        std::string_view utf8 = win1251_to_utf8[0x80 + i];
+        for (size_t j = 0; j < utf8.size(); ++j) {
+            result[i].bytes[j] = utf8[j];
+        }
+        result[i].size = (uint8_t)utf8.size();
+    }
+    return result;
+}();
+
+#if BX_SIMD_AVX2
+static constexpr size_t kAsciiBlockSize = 32;
+#else
+static constexpr size_t kAsciiBlockSize = 16;
+#endif
+
+// Копирует (с XOR) начало строки до первого байта >= 0x80, не больше count байт. Возвращает количество скопированных
+static size_t copyAsciiPrefix(const uint8_t* src, size_t count, char* dst, uint8_t xorKey) noexcept {
+    size_t i = 0;
+
+#if BX_SIMD_AVX2
+    const __m256i key32 = _mm256_set1_epi8((char)xorKey);
+    for (; i + 32 <= count; i += 32) {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(src + i)), key32);
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(v);
+        if (mask)
+            return i + std::countr_zero(mask);
+    }
+#endif
+
+#if BX_SIMD_SSE2
+    const __m128i key16 = _mm_set1_epi8((char)xorKey);
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + i)), key16);
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(v);
+        if (mask)
+            return i + std::countr_zero(mask);
+    }
+#elif BX_SIMD_NEON
+    const uint8x16_t key16 = vdupq_n_u8(xorKey);
+    const uint8x16_t high16 = vdupq_n_u8(0x80);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t v = veorq_u8(vld1q_u8(src + i), key16);
+        vst1q_u8((uint8_t*)(dst + i), v);
+        // Сужение до 4 бит на байт вместо отсутствующего в NEON movemask
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vcgeq_u8(v, high16)), 4)), 0);
+        if (mask)
+            return i + (std::countr_zero(mask) >> 2);
+    }
+#endif
+
+    // Хвост (и вариант без SIMD)
+    for (; i < count; ++i) {
+        const uint8_t ch = src[i] ^ xorKey;
+        if (ch >= 0x80)
+            return i;
+        dst[i] = (char)ch;
+    }
+    return count;
+}
+
 void StringUtils::toLowerAscii(std::string_view input, std::span<char> output) noexcept {
     assert(output.size() >= input.size());
     std::transform(input.begin(), input.end(), output.begin(), toLower);
@@ -137,29 +219,45 @@ std::string_view StringUtils::extractQuotedValue(std::string_view line) noexcept
 
 std::string StringUtils::decodeWin1251ToUtf8(std::string_view input) noexcept {
     std::string result;
-    result.reserve(input.size() * 2);
-    for (unsigned char ch : input) {
-        result += win1251_to_utf8[ch];
-    }
+    result.resize(input.size() * kMaxUtf8PerWin1251Char + 1);
+    result.resize(decodeWin1251ToUtf8Buffer(input, result));
     return result;
 }
 
-size_t StringUtils::decodeWin1251ToUtf8Buffer(std::string_view input, std::span<char> buffer) noexcept {
+size_t StringUtils::decodeWin1251ToUtf8Buffer(std::string_view input, std::span<char> buffer, uint8_t xorKey) noexcept {
     assert(!buffer.empty());
     assert(input.data() != buffer.data());
 
-    size_t pos = 0;
-    for (unsigned char ch : input) {
-        const std::string_view utf8View = win1251_to_utf8[ch];
-        size_t len = utf8View.length();
+    const uint8_t* src = (const uint8_t*)input.data();
+    const size_t size = input.size();
+    char* dst = buffer.data();
+    const size_t capacity = buffer.size() - 1; // Место под '\0'
 
-        // Проверка на достаточность места
-        assert(pos + len <= buffer.size() - 1);
+    size_t i = 0;
+    size_t pos = 0;
+    while (i < size) {
+        size_t asciiCount = copyAsciiPrefix(src + i, std::min(size - i, capacity - pos), dst + pos, xorKey);
+        i += asciiCount;
+        pos += asciiCount;
+
+        // Остаток блока (обычно кириллица вперемешку с пробелами) декодируется по таблице
+        const size_t blockEnd = std::min(i + kAsciiBlockSize, size);
+        for (; i < blockEnd; ++i) {
+            const uint8_t ch = src[i] ^ xorKey;
+            if (ch < 0x80) {
+                assert(pos < capacity);
+                dst[pos++] = (char)ch;
+                continue;
+            }
 
-        std::memcpy(buffer.data() + pos, utf8View.data(), len);
-        pos += len;
+            const Utf8Sequence& sequence = win1251HighToUtf8[ch - 0x80];
+            assert(pos + sequence.size <= capacity);
+            // Запись всех четырёх байт записи без ветвления по длине, лишнее перезапишется следующим символом
+            std::memcpy(dst + pos, &sequence, (pos + sizeof(Utf8Sequence) <= buffer.size()) ? sizeof(Utf8Sequence) : sequence.size);
+            pos += sequence.size;
+        }
     }
-    buffer[pos] = '\0';
+    dst[pos] = '\0';
     return pos;
 }
 
@@ -34,7 +34,8 @@ public:
 
     static std::string_view extractQuotedValue(std::string_view line) noexcept;
     static std::string decodeWin1251ToUtf8(std::string_view input) noexcept;
-    static size_t decodeWin1251ToUtf8Buffer(std::string_view input, std::span<char> buffer) noexcept;
+    // xorKey снимается с каждого байта до декодирования (зашифрованные SDB). Буфер: до трёх байт на символ и '\0'
+    static size_t decodeWin1251ToUtf8Buffer(std::string_view input, std::span<char> buffer, uint8_t xorKey = 0) noexcept;
 
     template <LineCallback Callback>
     static void forEachLine(std::string_view buffer, Callback&& callback) noexcept;
@@ -0,0 +1,309 @@
+#include "Telemetry.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <memory>
+#include <array>
+#include <mutex>
+
+namespace {
+
+// Замер упакован в одно слово, чтобы читатель никогда не видел половину записи
+constexpr int kDurationBits = 48;
+constexpr uint64_t kDurationMask = (uint64_t(1) << kDurationBits) - 1;
+
+// Кольцо одного потока: пишет только владелец, читает только collect
+struct ThreadRing {
+    std::array<std::atomic<uint64_t>, Telemetry::kRingCapacity> events;
+    std::atomic<uint64_t> head = 0;
+    uint64_t tail = 0; // Под s_collectMutex
+};
+
+struct ZoneAccumulator {
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t lastNs = 0;
+    uint64_t maxNs = 0;
+    std::vector<uint64_t> window; // Последние kPercentileWindow замеров по кругу
+    size_t windowPos = 0;
+};
+
+std::mutex s_zonesMutex;
+std::vector<std::string> s_zoneNames;
+std::unordered_map<std::string, uint16_t> s_zoneIds;
+
+std::mutex s_ringsMutex;
+std::vector<std::unique_ptr<ThreadRing>> s_rings; // Все кольца, в том числе свободные: в них могут оставаться несобранные замеры
+std::vector<ThreadRing*> s_freeRings;             // Кольца завершившихся потоков, их забирают новые потоки
+
+std::mutex s_collectMutex;
+std::vector<ZoneAccumulator> s_accumulators;
+uint64_t s_droppedEvents = 0;
+uint64_t s_lastFrameNs = 0;
+std::vector<uint64_t> s_collectScratch;
+
+// Кольцо занимает поток до своего завершения, потом возвращается в s_freeRings.
+// Так колец не больше, чем потоков, живших одновременно, а не по одному на каждый поток за всё время
+class ThreadRingOwner
+{
+public:
+    ThreadRingOwner() {
+        std::lock_guard lock(s_ringsMutex);
+        if (!s_freeRings.empty()) {
+            m_ring = s_freeRings.back();
+            s_freeRings.pop_back();
+        } else {
+            s_rings.push_back(std::make_unique<ThreadRing>());
+            m_ring = s_rings.back().get();
+        }
+    }
+
+    ~ThreadRingOwner() {
+        // Новый владелец продолжит с того же head, несобранные замеры заберёт collect
+        std::lock_guard lock(s_ringsMutex);
+        s_freeRings.push_back(m_ring);
+    }
+
+    ThreadRingOwner(const ThreadRingOwner&) = delete;
+    ThreadRingOwner& operator=(const ThreadRingOwner&) = delete;
+
+    ThreadRing& ring() { return *m_ring; }
+
+private:
+    ThreadRing* m_ring;
+};
+
+ThreadRing& threadRing()
+{
+    thread_local ThreadRingOwner owner;
+    return owner.ring();
+}
+
+void accumulate(uint16_t zoneId, uint64_t durationNs)
+{
+    if (zoneId >= s_accumulators.size()) {
+        s_accumulators.resize(zoneId + 1);
+    }
+    ZoneAccumulator& zone = s_accumulators[zoneId];
+    ++zone.count;
+    zone.totalNs += durationNs;
+    zone.lastNs = durationNs;
+    zone.maxNs = std::max(zone.maxNs, durationNs);
+    if (zone.window.size() < Telemetry::kPercentileWindow) {
+        zone.window.push_back(durationNs);
+    } else {
+        zone.window[zone.windowPos] = durationNs;
+        zone.windowPos = (zone.windowPos + 1) % Telemetry::kPercentileWindow;
+    }
+}
+
+double percentileMs(std::vector<uint64_t>& values, double percentile)
+{
+    if (values.empty()) return 0.0;
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(percentile * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index] / 1e6;
+}
+
+std::string csvQuoted(std::string_view text)
+{
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"') result += '"';
+        result += c;
+    }
+    result += '"';
+    return result;
+}
+
+std::string jsonQuoted(std::string_view text)
+{
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') result += '\\';
+        result += c;
+    }
+    result += '"';
+    return result;
+}
+
+} // namespace
+
+uint16_t Telemetry::registerZone(std::string_view name)
+{
+    std::lock_guard lock(s_zonesMutex);
+    auto [it, inserted] = s_zoneIds.try_emplace(std::string(name), kNoZone);
+    if (inserted) {
+        if (s_zoneNames.size() >= kNoZone) {
+            return kNoZone;
+        }
+        it->second = static_cast<uint16_t>(s_zoneNames.size());
+        s_zoneNames.emplace_back(name);
+    }
+    return it->second;
+}
+
+// "static bool CSX_Parser::parse(std::string_view, ...)" -> "CSX_Parser::parse"
+uint16_t Telemetry::registerFunctionZone(std::string_view prettyFunction)
+{
+    size_t end = prettyFunction.size();
+    int depth = 0;
+    for (size_t i = 0; i < prettyFunction.size(); ++i) {
+        const char c = prettyFunction[i];
+        if (c == '<') ++depth;
+        else if (c == '>') --depth;
+        else if (c == '(' && depth == 0 && i > 0) {
+            end = i;
+            break;
+        }
+    }
+
+    size_t begin = 0;
+    depth = 0;
+    for (size_t i = end; i > 0; --i) {
+        const char c = prettyFunction[i - 1];
+        if (c == '>') ++depth;
+        else if (c == '<') --depth;
+        else if (c == ' ' && depth == 0) {
+            begin = i;
+            break;
+        }
+    }
+    return registerZone(prettyFunction.substr(begin, end - begin));
+}
+
+void Telemetry::record(uint16_t zoneId, uint64_t durationNs) noexcept
+{
+    ThreadRing& ring = threadRing();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    const uint64_t event = (uint64_t(zoneId) << kDurationBits) | std::min(durationNs, kDurationMask);
+    ring.events[head % kRingCapacity].store(event, std::memory_order_relaxed);
+    // Замер публикуется сдвигом head уже после записи слота
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Telemetry::frameMark()
+{
+    static const uint16_t frameZoneId = registerZone("Frame");
+    const uint64_t now = nowNs();
+    {
+        std::lock_guard lock(s_collectMutex);
+        if (s_lastFrameNs != 0) {
+            accumulate(frameZoneId, now - s_lastFrameNs);
+        }
+        s_lastFrameNs = now;
+    }
+    collect();
+}
+
+void Telemetry::collect()
+{
+    std::lock_guard ringsLock(s_ringsMutex);
+    std::lock_guard lock(s_collectMutex);
+    std::vector<uint64_t>& events = s_collectScratch;
+    for (const std::unique_ptr<ThreadRing>& ring : s_rings) {
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        if (head - ring->tail > kRingCapacity) {
+            s_droppedEvents += head - ring->tail - kRingCapacity;
+            ring->tail = head - kRingCapacity;
+        }
+
+        events.clear();
+        for (uint64_t index = ring->tail; index < head; ++index) {
+            events.push_back(ring->events[index % kRingCapacity].load(std::memory_order_relaxed));
+        }
+
+        // Проверка как у seqlock: пока шло чтение, писатель мог обогнать его на целое кольцо.
+        // Барьер не даёт чтению слотов переместиться за повторное чтение head.
+        // Писатель сначала пишет слот currentHead и только потом сдвигает head, поэтому
+        // замер currentHead - kRingCapacity тоже мог быть затёрт
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t currentHead = ring->head.load(std::memory_order_relaxed);
+        const uint64_t firstIntact = currentHead + 1 > kRingCapacity ? currentHead + 1 - kRingCapacity : 0;
+        const uint64_t overwritten = std::min<uint64_t>(events.size(),
+            firstIntact > ring->tail ? firstIntact - ring->tail : 0);
+        s_droppedEvents += overwritten;
+        for (size_t i = overwritten; i < events.size(); ++i) {
+            accumulate(static_cast<uint16_t>(events[i] >> kDurationBits), events[i] & kDurationMask);
+        }
+        ring->tail = head;
+    }
+}
+
+std::vector<Telemetry::ZoneStats> Telemetry::stats()
+{
+    std::vector<ZoneStats> result;
+    std::vector<std::string> names;
+    {
+        std::lock_guard lock(s_zonesMutex);
+        names = s_zoneNames;
+    }
+
+    std::lock_guard lock(s_collectMutex);
+    std::vector<uint64_t> window;
+    for (size_t zoneId = 0; zoneId < s_accumulators.size(); ++zoneId) {
+        const ZoneAccumulator& zone = s_accumulators[zoneId];
+        if (zone.count == 0) continue;
+
+        ZoneStats stats;
+        stats.name = zoneId < names.size() ? names[zoneId] : std::format("zone {}", zoneId);
+        stats.count = zone.count;
+        stats.totalMs = zone.totalNs / 1e6;
+        stats.lastMs = zone.lastNs / 1e6;
+        stats.maxMs = zone.maxNs / 1e6;
+        window = zone.window;
+        stats.p50Ms = percentileMs(window, 0.50);
+        stats.p95Ms = percentileMs(window, 0.95);
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+uint64_t Telemetry::droppedEvents()
+{
+    std::lock_guard lock(s_collectMutex);
+    return s_droppedEvents;
+}
+
+void Telemetry::reset()
+{
+    collect();
+    std::lock_guard lock(s_collectMutex);
+    s_accumulators.clear();
+    s_droppedEvents = 0;
+}
+
+std::string Telemetry::toCsv(const std::vector<ZoneStats>& stats)
+{
+    std::string result = "zone,count,total_ms,last_ms,p50_ms,p95_ms,max_ms\n";
+    for (const ZoneStats& zone : stats) {
+        result += std::format("{},{},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f}\n",
+                              csvQuoted(zone.name), zone.count,
+                              zone.totalMs, zone.lastMs, zone.p50Ms, zone.p95Ms, zone.maxMs);
+    }
+    return result;
+}
+
+std::string Telemetry::toJson(const std::vector<ZoneStats>& stats)
+{
+    std::string result = "{\n  \"zones\": [";
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const ZoneStats& zone = stats[i];
+        result += std::format("{}\n    {{\"zone\": {}, \"count\": {}, \"total_ms\": {:.4f}, \"last_ms\": {:.4f}, "
+                              "\"p50_ms\": {:.4f}, \"p95_ms\": {:.4f}, \"max_ms\": {:.4f}}}",
+                              i == 0 ? "" : ",",
+                              jsonQuoted(zone.name), zone.count,
+                              zone.totalMs, zone.lastMs, zone.p50Ms, zone.p95Ms, zone.maxMs);
+    }
+    result += std::format("\n  ],\n  \"dropped_events\": {}\n}}\n", droppedEvents());
+    return result;
+}
+
+uint64_t Telemetry::nowNs() noexcept
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
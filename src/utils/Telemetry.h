@@ -0,0 +1,101 @@
+#pragma once
+#include <string_view>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Встроенная телеметрия: время зон из макросов Tracy_* без сервера Tracy.
+// Каждый поток пишет замеры в свой кольцевой буфер без блокировок. Поток UI раз в кадр (frameMark)
+// забирает их и ведёт по каждой зоне количество, сумму, максимум и окно последних замеров для p50/p95.
+// Если поток записал больше kRingCapacity замеров между двумя кадрами, старые теряются (droppedEvents)
+class Telemetry
+{
+public:
+    Telemetry() = delete;
+
+    static constexpr size_t kRingCapacity = 8192;
+    static constexpr size_t kPercentileWindow = 1024;
+    static constexpr uint16_t kNoZone = UINT16_MAX;
+
+    struct ZoneStats {
+        std::string name;
+        uint64_t count = 0;
+        double totalMs = 0.0;
+        double lastMs = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double maxMs = 0.0;
+    };
+
+    // Id зоны по имени. Одно имя всегда даёт один id. kNoZone, если зон слишком много
+    static uint16_t registerZone(std::string_view name);
+    // То же для __PRETTY_FUNCTION__: остаётся только квалифицированное имя функции
+    static uint16_t registerFunctionZone(std::string_view prettyFunction);
+
+    static void record(uint16_t zoneId, uint64_t durationNs) noexcept;
+    // Конец кадра: замер интервала между кадрами и сбор буферов всех потоков
+    static void frameMark();
+
+    static void collect();
+    static std::vector<ZoneStats> stats();
+    static uint64_t droppedEvents();
+    static void reset();
+
+    static std::string toCsv(const std::vector<ZoneStats>& stats);
+    static std::string toJson(const std::vector<ZoneStats>& stats);
+
+    static uint64_t nowNs() noexcept;
+
+    class ScopedZone {
+    public:
+        explicit ScopedZone(uint16_t zoneId) noexcept : m_zoneId(zoneId), m_startNs(nowNs()) {}
+        ~ScopedZone() { end(); }
+
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+
+        void end() noexcept {
+            if (m_zoneId != kNoZone) {
+                record(m_zoneId, nowNs() - m_startNs);
+                m_zoneId = kNoZone;
+            }
+        }
+
+    private:
+        uint16_t m_zoneId;
+        uint64_t m_startNs;
+    };
+};
+
+#ifdef GOLDENLAND_TELEMETRY
+    #if defined(_MSC_VER)
+        #define Telemetry_Function __FUNCTION__
+    #else
+        #define Telemetry_Function __PRETTY_FUNCTION__
+    #endif
+
+    #define Telemetry_Concat2(a, b) a##b
+    #define Telemetry_Concat(a, b) Telemetry_Concat2(a, b)
+
+    #define Telemetry_ZoneScoped \
+        static const uint16_t Telemetry_Concat(telemetryZoneId, __LINE__) = Telemetry::registerFunctionZone(Telemetry_Function); \
+        Telemetry::ScopedZone Telemetry_Concat(telemetryZone, __LINE__)(Telemetry_Concat(telemetryZoneId, __LINE__))
+    #define Telemetry_ZoneScopedN(name) \
+        static const uint16_t Telemetry_Concat(telemetryZoneId, __LINE__) = Telemetry::registerZone(name); \
+        Telemetry::ScopedZone Telemetry_Concat(telemetryZone, __LINE__)(Telemetry_Concat(telemetryZoneId, __LINE__))
+
+    #define Telemetry_ZoneStartN(name) \
+        static const uint16_t ctxTelemetryId = Telemetry::registerZone(name); \
+        Telemetry::ScopedZone ctxTelemetry(ctxTelemetryId)
+    #define Telemetry_ZoneEnd() ctxTelemetry.end()
+
+    #define Telemetry_FrameMark Telemetry::frameMark()
+#else
+    #define Telemetry_ZoneScoped
+    #define Telemetry_ZoneScopedN(name)
+
+    #define Telemetry_ZoneStartN(name)
+    #define Telemetry_ZoneEnd()
+
+    #define Telemetry_FrameMark
+#endif
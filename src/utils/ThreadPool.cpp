@@ -0,0 +1,54 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+#include "utils/TracyProfiler.h"
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    threadCount = std::max(threadCount, 1u);
+    m_threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] () { return m_stop || !m_tasks.empty(); });
+
+            // Оставшиеся задачи выполняются до конца, их future могут ожидать
+            if (m_stop && m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        Tracy_ZoneScopedN("ThreadPool task");
+        task();
+    }
+}
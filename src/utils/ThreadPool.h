@@ -0,0 +1,57 @@
+#pragma once
+#include <condition_variable>
+#include <type_traits>
+#include <functional>
+#include <future>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <queue>
+#include <mutex>
+
+// Пул потоков фиксированного размера.
+// Задачи не должны ждать результат других задач этого же пула (возможна взаимная блокировка)
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    template<class Task>
+    auto submit(Task&& task) -> std::future<std::invoke_result_t<std::decay_t<Task>>>;
+
+    size_t threadCount() const { return m_threads.size(); }
+
+    // Общий пул приложения
+    static ThreadPool& shared();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_threads;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stop = false;
+};
+
+template<class Task>
+auto ThreadPool::submit(Task&& task) -> std::future<std::invoke_result_t<std::decay_t<Task>>>
+{
+    using Result = std::invoke_result_t<std::decay_t<Task>>;
+
+    // std::function требует копируемый объект, поэтому packaged_task хранится в shared_ptr
+    auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+    std::future<Result> future = packagedTask->get_future();
+    {
+        std::lock_guard lock(m_mutex);
+        m_tasks.emplace([packagedTask] () { (*packagedTask)(); });
+    }
+    m_condition.notify_one();
+    return future;
+}
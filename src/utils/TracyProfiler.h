@@ -1,5 +1,7 @@
 #pragma once
+#include "utils/Telemetry.h"
 
+// Зоны и кадры также попадают во встроенную телеметрию (utils/Telemetry.h), если она включена
 #ifdef TRACY_ENABLE
     #include "tracy/Tracy.hpp"
     #include "tracy/TracyC.h"
@@ -9,11 +11,11 @@
         void operator delete(void* ptr) noexcept;
     #endif
 
-    #define Tracy_ZoneScoped ZoneScoped
-    #define Tracy_ZoneScopedN(name) ZoneScopedN(name)
+    #define Tracy_ZoneScoped ZoneScoped; Telemetry_ZoneScoped
+    #define Tracy_ZoneScopedN(name) ZoneScopedN(name); Telemetry_ZoneScopedN(name)
 
-    #define Tracy_ZoneStartN(name) TracyCZoneN(ctx, name, true)
-    #define Tracy_ZoneEnd() TracyCZoneEnd(ctx)
+    #define Tracy_ZoneStartN(name) TracyCZoneN(ctx, name, true); Telemetry_ZoneStartN(name)
+    #define Tracy_ZoneEnd() TracyCZoneEnd(ctx); Telemetry_ZoneEnd()
 
     #define Tracy_ZoneText(txt, size) ZoneText(txt, size)
     #define Tracy_ZoneTextF(fmt, ...) ZoneTextF(fmt, ##__VA_ARGS__)
@@ -22,7 +24,8 @@
     #define Tracy_Message(txt, size) TracyMessage(txt, size)
     #define Tracy_MessageC(txt, size, color) TracyMessageC(txt, size, color)
 
-    #define Tracy_FrameMark FrameMark
+    #define Tracy_FrameMark FrameMark; Telemetry_FrameMark
+    #define Tracy_Plot(name, value) TracyPlot(name, value)
     #define Tracy_FrameImage(image, width, height, offset, flip) FrameImage(image, width, height, offset, flip)
 
     #define Tracy_CaptureImage(renderer) TracyProfilerInternal::CaptureImage(renderer)
@@ -42,11 +45,11 @@
         void TrackStbImageMemory();
     }
 #else
-    #define Tracy_ZoneScoped
-    #define Tracy_ZoneScopedN(name)
+    #define Tracy_ZoneScoped Telemetry_ZoneScoped
+    #define Tracy_ZoneScopedN(name) Telemetry_ZoneScopedN(name)
 
-    #define Tracy_ZoneStartN(name)
-    #define Tracy_ZoneEnd()
+    #define Tracy_ZoneStartN(name) Telemetry_ZoneStartN(name)
+    #define Tracy_ZoneEnd() Telemetry_ZoneEnd()
 
     #define Tracy_ZoneText(txt, size)
     #define Tracy_ZoneTextF(fmt, ...)
@@ -55,7 +58,8 @@
     #define Tracy_Message(txt, size)
     #define Tracy_MessageC(txt, size, color)
 
-    #define Tracy_FrameMark
+    #define Tracy_FrameMark Telemetry_FrameMark
+    #define Tracy_Plot(name, value)
     #define Tracy_FrameImage(image, width, height, offset, flip)
 
     #define Tracy_CaptureImage(renderer)
@@ -15,7 +15,7 @@ void CsExecutorViewer::update(bool& showWindow,
                               bool& needUpdate,
                               std::string_view title,
                               std::span<const CS_Node> nodes,
-                              const std::map<int, std::string>& dialogsPhrases,
+                              const SDB_Strings& dialogsPhrases,
                               const StringHashTable<AgeVariable_t>& globalVars)
 {
     if (needUpdate) {
@@ -16,7 +16,7 @@ public:
                 bool& needUpdate,
                 std::string_view title,
                 std::span<const CS_Node> nodes,
-                const std::map<int, std::string>& dialogsPhrases,
+                const SDB_Strings& dialogsPhrases,
                 const StringHashTable<AgeVariable_t>& globalVars);
 
     bool isNodeExecuted(int index) const;
@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <format>
+#include <set>
 
 #include "enums/CsFunctions.h"
 #include "enums/CsOpcodes.h"
@@ -19,7 +20,7 @@ CsViewer::CsViewer() {}
 void CsViewer::update(bool& showWindow,
                       std::string_view rootDirectory,
                       const std::vector<std::string>& csFiles,
-                      const std::map<int, std::string>& dialogPhrases,
+                      const SDB_Strings& dialogPhrases,
                       const StringHashTable<AgeVariable_t>& globalVars)
 {
     Tracy_ZoneScoped;
@@ -16,7 +16,7 @@ public:
     void update(bool& showWindow,
                 std::string_view rootDirectory,
                 const std::vector<std::string>& csFiles,
-                const std::map<int, std::string>& dialogPhrases,
+                const SDB_Strings& dialogPhrases,
                 const StringHashTable<AgeVariable_t>& globalVars);
 
     void injectPlaySoundAndGeneratePhrases(std::string_view saveRootDirectory, std::string_view rootDirectory, const std::vector<std::string>& csFiles);
@@ -13,7 +13,7 @@
 
 CsxViewer::CsxViewer() {}
 
-void CsxViewer::update(bool& showWindow, SDL_Renderer* renderer, std::string_view rootDirectory, const std::vector<std::string>& csxFiles)
+void CsxViewer::update(bool& showWindow, SDL_Renderer* renderer, TextureCache& textureCache, std::string_view rootDirectory, const std::vector<std::string>& csxFiles)
 {
     Tracy_ZoneScoped;
     m_saveDialogData.renderer = renderer;
@@ -38,8 +38,15 @@ void CsxViewer::update(bool& showWindow, SDL_Renderer* renderer, std::string_vie
                     {
                         m_selectedIndex = i;
 
-                        m_csxTextures.clear();
-                        TextureLoader::loadTexturesFromCsxFile(std::format("{}/{}", rootDirectory, csxFiles[i]), renderer, m_csxTextures, &m_csxTextureError);
+                        m_csxTextureError.clear();
+                        std::string csxPath = std::format("{}/{}", rootDirectory, csxFiles[i]);
+                        m_csxTextures = textureCache.load(csxPath, "split", [&]() -> std::optional<TextureSet> {
+                            TextureSet result;
+                            if (!TextureLoader::loadTexturesFromCsxFile(csxPath, renderer, result, &m_csxTextureError)) {
+                                return std::nullopt;
+                            }
+                            return result;
+                        });
 
                         needResetScroll = true;
                     }
@@ -51,7 +58,7 @@ void CsxViewer::update(bool& showWindow, SDL_Renderer* renderer, std::string_vie
         ImGui::SameLine();
 
         // Right
-        if (!m_csxTextures.empty()) {
+        if (m_csxTextures && !m_csxTextures->empty()) {
             ImGui::BeginGroup();
             {
                 ImGui::BeginChild("item view", ImVec2(0, -ImGui::GetFrameHeightWithSpacing() * 2), 0, ImGuiWindowFlags_HorizontalScrollbar);
@@ -65,7 +72,7 @@ void CsxViewer::update(bool& showWindow, SDL_Renderer* renderer, std::string_vie
 
                 int csxTextureWidth = 0;
                 int csxTextureHeight = 0;
-                for (const auto& csxTexture : m_csxTextures) {
+                for (const auto& csxTexture : *m_csxTextures) {
                     csxTextureWidth = csxTexture->w;
                     csxTextureHeight += csxTexture->h;
                     ImGui::ImageWithBg((ImTextureID)csxTexture.get(), ImVec2(csxTexture->w, csxTexture->h), ImVec2(0, 0), ImVec2(1, 1), m_bgColor);
@@ -145,7 +152,7 @@ void CsxViewer::update(bool& showWindow, SDL_Renderer* renderer, std::string_vie
     // Очистка
     if (!showWindow && !m_onceWhenClose) {
         m_selectedIndex = -1;
-        m_csxTextures.clear();
+        m_csxTextures.reset();
         m_csxTextureError.clear();
         m_textFilter.Clear();
         m_onceWhenClose = true;
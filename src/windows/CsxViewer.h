@@ -4,7 +4,7 @@
 
 #include "imgui.h"
 
-#include "graphics/Texture.h"
+#include "graphics/TextureCache.h"
 
 struct SDL_Renderer;
 
@@ -12,7 +12,7 @@ class CsxViewer {
 public:
     CsxViewer();
 
-    void update(bool& showWindow, SDL_Renderer* renderer, std::string_view rootDirectory, const std::vector<std::string>& csxFiles);
+    void update(bool& showWindow, SDL_Renderer* renderer, TextureCache& textureCache, std::string_view rootDirectory, const std::vector<std::string>& csxFiles);
 
 private:
     struct SaveDialogData {
@@ -21,7 +21,7 @@ private:
     };
 
     int m_selectedIndex = -1;
-    std::vector<Texture> m_csxTextures;
+    TextureHandle m_csxTextures;
     std::string m_csxTextureError;
     ImVec4 m_bgColor = ImVec4(1.0f, 1.0f, 1.0f, 0.0f);
     int m_activeButtonIndex = 0;
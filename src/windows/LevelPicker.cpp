@@ -6,13 +6,8 @@
 #include "imgui.h"
 #include "imgui_internal.h"
 
-#include "embedded_resources.h"
-#include "graphics/TextureLoader.h"
-#include "parsers/SEF_Parser.h"
 #include "utils/TracyProfiler.h"
 #include "utils/StringUtils.h"
-#include "utils/FileUtils.h"
-#include "utils/DebugLog.h"
 
 LevelPicker::LevelPicker() :
     m_title("Load Level")
@@ -22,6 +17,7 @@ LevelPicker::LevelPicker() :
 
 LevelPickerResult LevelPicker::update(bool& showWindow,
                                       SDL_Renderer* renderer,
+                                      TextureCache& textureCache,
                                       std::string_view rootDirectory,
                                       const std::vector<std::string>& singleLevelNames,
                                       const std::vector<std::string>& multiLevelNames,
@@ -31,13 +27,15 @@ LevelPickerResult LevelPicker::update(bool& showWindow,
     const ImGuiIO& io = ImGui::GetIO();
     LevelPickerResult result;
 
+    m_thumbnails.setRootDirectory(rootDirectory, renderer);
+
     if ( showWindow && !ImGui::IsPopupOpen(m_title.data()) ) {
         ImGui::OpenPopup(m_title.data());
 
         if (multiLevelNames.empty()) {
             m_type = LevelType::kSingle;
         }
-        loadPreview(rootDirectory, levelNames(singleLevelNames, multiLevelNames)[selectedLevelIndex], renderer);
+        prefetchPreviews(levelNames(singleLevelNames, multiLevelNames), selectedLevelIndex);
     }
 
     ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f),
@@ -49,13 +47,13 @@ LevelPickerResult LevelPicker::update(bool& showWindow,
             if (ImGui::RadioButton("Single", m_type == LevelType::kSingle)) {
                 m_type = LevelType::kSingle;
                 selectedLevelIndex = 0;
-                loadPreview(rootDirectory, levelNames(singleLevelNames, multiLevelNames)[selectedLevelIndex], renderer);
+                prefetchPreviews(levelNames(singleLevelNames, multiLevelNames), selectedLevelIndex);
             }
             ImGui::SameLine();
             if (ImGui::RadioButton("Multiplayer", m_type == LevelType::kMultiplayer)) {
                 m_type = LevelType::kMultiplayer;
                 selectedLevelIndex = 0;
-                loadPreview(rootDirectory, levelNames(singleLevelNames, multiLevelNames)[selectedLevelIndex], renderer);
+                prefetchPreviews(levelNames(singleLevelNames, multiLevelNames), selectedLevelIndex);
             }
             ImGui::Dummy({0, 0}); // Отступ
         }
@@ -72,11 +70,14 @@ LevelPickerResult LevelPicker::update(bool& showWindow,
                 writeLevelHumanNameToBuffer(levelHumanNamesDict, levelNames(singleLevelNames, multiLevelNames)[i], levelNameBuffer);
                 if (ImGui::Selectable(levelNameBuffer, isSelected)) {
                     selectedLevelIndex = i;
-                    loadPreview(rootDirectory, levelNames(singleLevelNames, multiLevelNames)[selectedLevelIndex], renderer);
+                    prefetchPreviews(levelNames(singleLevelNames, multiLevelNames), selectedLevelIndex);
                 }
                 if (isSelected) {
                     ImGui::SetItemDefaultFocus();
                 }
+                if (ImGui::IsItemHovered() || ImGui::IsItemFocused()) {
+                    prefetchPreviews(levelNames(singleLevelNames, multiLevelNames), i);
+                }
             }
             ImGui::EndCombo();
         }
@@ -86,10 +87,10 @@ LevelPickerResult LevelPicker::update(bool& showWindow,
         ImVec2 bgSize(128, 112);
         ImGui::Dummy(bgSize);
 
-        if (m_preview.isValid()) {
+        if (const Texture* preview = m_thumbnails.texture(m_type, currentLevelName, renderer, textureCache)) {
             ImDrawList* drawList = ImGui::GetWindowDrawList();
 
-            ImVec2 imageSize(m_preview->w, m_preview->h);
+            ImVec2 imageSize((*preview)->w, (*preview)->h);
             if (imageSize.x > bgSize.x) {
                 float ratio = bgSize.x / imageSize.x;
                 imageSize.x = bgSize.x;
@@ -105,7 +106,7 @@ LevelPickerResult LevelPicker::update(bool& showWindow,
 
             ImRect imageBox(imagePos, ImVec2(imagePos.x + imageSize.x, imagePos.y + imageSize.y));
 
-            drawList->AddImage((ImTextureID)m_preview.get(), imageBox.Min, imageBox.Max);
+            drawList->AddImage((ImTextureID)preview->get(), imageBox.Min, imageBox.Max);
             imageBox.Expand(1);
             drawList->AddRect(imageBox.Min, imageBox.Max, IM_COL32(200, 200, 200, 255));
         }
@@ -137,39 +138,16 @@ void LevelPicker::writeLevelHumanNameToBuffer(const StringHashTable<std::string>
     }
 }
 
-void LevelPicker::loadPreview(std::string_view rootDirectory,
-                              std::string_view selectedLevelName,
-                              SDL_Renderer* renderer)
+void LevelPicker::prefetchPreviews(const std::vector<std::string>& levelNames, int levelIndex)
 {
     Tracy_ZoneScoped;
-    bool loadPreviewOk = false;
-    m_preview = {};
-
-    char pathBuffer[768];
-    StringUtils::formatToBuffer(pathBuffer, "{0}/levels/{1}/{2}/{2}.sef", rootDirectory, levelTypeToString(m_type), selectedLevelName);
-
-    char pack[32];
-    bool packParseOk = SEF_Parser::fastPackParse(pathBuffer, pack, &m_previewError);
-    if (packParseOk) {
-        StringUtils::formatToBuffer(pathBuffer, "{}/levels/pack/{}/bitmaps/layer.jpg", rootDirectory, pack);
-
-        auto previewBuffer = FileUtils::loadJpegPhotoshopThumbnail(pathBuffer, &m_previewError);
-        if (!previewBuffer.empty()) {
-            if (TextureLoader::loadTextureFromMemory(previewBuffer, renderer, m_preview, &m_previewError)) {
-                loadPreviewOk = true;
-            } else {
-                LogFmt("loadTextureFromMemory error: {}", m_previewError);
-            }
-        } else {
-            LogFmt("loadJpegPhotoshopThumbnail error: {}", m_previewError);
+    const int count = static_cast<int>(levelNames.size());
+    for (int offset = 0; offset <= kPrefetchRadius; ++offset) {
+        if (levelIndex + offset < count) {
+            m_thumbnails.prefetch(m_type, levelNames[levelIndex + offset]);
         }
-    } else {
-        LogFmt("fastPackParse error: {}", m_previewError);
-    }
-
-    if (!loadPreviewOk) {
-        if (!TextureLoader::loadTextureFromMemory({question_bmp, question_bmp_size}, renderer, m_preview, &m_previewError)) {
-            LogFmt("loadTextureFromMemory error: {}", m_previewError);
+        if (offset > 0 && levelIndex - offset >= 0) {
+            m_thumbnails.prefetch(m_type, levelNames[levelIndex - offset]);
         }
     }
 }
@@ -4,7 +4,8 @@
 #include <vector>
 #include <span>
 
-#include "graphics/Texture.h"
+#include "graphics/TextureCache.h"
+#include "LevelThumbnails.h"
 #include "Types.h"
 
 struct SDL_Renderer;
@@ -21,6 +22,7 @@ public:
 
     LevelPickerResult update(bool& showWindow,
                              SDL_Renderer* renderer,
+                             TextureCache& textureCache,
                              std::string_view rootDirectory,
                              const std::vector<std::string>& singleLevelNames,
                              const std::vector<std::string>& multiLevelNames,
@@ -37,14 +39,16 @@ public:
                                      std::string_view levelName,
                                      std::span<char> outLevelNameBuffer);
 
-    void loadPreview(std::string_view rootDirectory,
-                     std::string_view selectedLevelName,
-                     SDL_Renderer* renderer);
+    // Миниатюры выбранного уровня и его соседей декодируются заранее
+    void prefetchPreviews(const std::vector<std::string>& levelNames, int levelIndex);
+
+    bool isLoadingPreview() const { return m_thumbnails.isLoading(); }
 
 private:
+    static constexpr int kPrefetchRadius = 3;
+
     std::string_view m_title;
     LevelType m_type = LevelType::kSingle;
 
-    Texture m_preview;
-    std::string m_previewError;
+    LevelThumbnails m_thumbnails;
 };
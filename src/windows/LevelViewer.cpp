@@ -1,5 +1,6 @@
 #include "LevelViewer.h"
 
+#include <charconv>
 #include <format>
 
 #include <SDL3/SDL_timer.h>
@@ -14,7 +15,7 @@
 
 LevelViewer::LevelViewer() {}
 
-void LevelViewer::update(bool& showWindow, std::string_view rootDirectory, Level& level)
+void LevelViewer::update(bool& showWindow, SDL_Renderer* renderer, std::string_view rootDirectory, Level& level)
 {
     Tracy_ZoneScoped;
     auto levelWindowName = Level::levelWindowName(level.data().name, level.data().type);
@@ -23,6 +24,9 @@ void LevelViewer::update(bool& showWindow, std::string_view rootDirectory, Level
     std::string viewportWindowName = std::format("Viewport##{}", levelWindowName);
     std::string objectsWindowName = std::format("Objects ({})", levelWindowName);
 
+    // Заполняется в drawAnimations, если область уровня видна
+    level.data().imgui.nextAnimationFrameMs = 0;
+
     ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0, 0));
     bool isLevelWindowVisible = ImGui::Begin(levelWindowName.c_str(), &showWindow, ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_MenuBar);
     bool anyWindowFocused = ImGui::IsWindowFocused() || ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows | ImGuiFocusedFlags_DockHierarchy);
@@ -132,7 +136,7 @@ void LevelViewer::update(bool& showWindow, std::string_view rootDirectory, Level
                 drawTriggers(level, startPos);
             }
             if (level.data().imgui.showMapTiles) {
-                drawMapTiles(level, startPos);
+                drawMapTiles(level, renderer, startPos);
             }
 
             drawSelectionHighlight(level, startPos);
@@ -166,8 +170,6 @@ void LevelViewer::update(bool& showWindow, std::string_view rootDirectory, Level
             }
             ImGui::End();
         }
-    } else { // Invisible level window
-        level.data().imgui.hasVisibleAnimations = false;
     }
 }
 
@@ -237,11 +239,11 @@ void LevelViewer::drawObjectsList(Level& level)
             ImGui::PushID(animation.description.number);
             if (ImGui::Button(animation.description.name.c_str())) {
                 ImVec2 animationCenter = {
-                    animation.description.position.x + (animation.textures.front()->w * 0.5f),
-                    animation.description.position.y + (animation.textures.front()->h * 0.5f)
+                    animation.description.position.x + (animation.frames.front().w * 0.5f),
+                    animation.description.position.y + (animation.frames.front().h * 0.5f)
                 };
-                levelScrollTo(level, animationCenter, {animation.textures.front()->w * 0.3f,
-                                                       animation.textures.front()->h * 0.3f});
+                levelScrollTo(level, animationCenter, {animation.frames.front().w * 0.3f,
+                                                       animation.frames.front().h * 0.3f});
             }
             ImGui::PopID();
         }
@@ -270,10 +272,10 @@ void LevelViewer::drawObjectsList(Level& level)
         for (const LevelTrigger& trigger : level.data().triggers) {
             if (ImGui::Button(trigger.lvlDescription.name.c_str())) {
                 ImVec2 triggerCenter = {
-                    trigger.lvlDescription.position.x + (trigger.texture->w * 0.5f),
-                    trigger.lvlDescription.position.y + (trigger.texture->h * 0.5f),
+                    trigger.lvlDescription.position.x + (trigger.region.w * 0.5f),
+                    trigger.lvlDescription.position.y + (trigger.region.h * 0.5f),
                 };
-                levelScrollTo(level, triggerCenter, {trigger.texture->w * 0.5f, trigger.texture->h * 0.5f});
+                levelScrollTo(level, triggerCenter, {trigger.region.w * 0.5f, trigger.region.h * 0.5f});
             }
         }
     }
@@ -281,11 +283,16 @@ void LevelViewer::drawObjectsList(Level& level)
 
 bool LevelViewer::isAnimating(const Level& level) const
 {
-    bool showLevelAnimation = level.data().imgui.showAnimations && level.data().imgui.hasVisibleAnimations;
+    // Анимации объектов уровня сюда не входят: им нужен кадр только к смене кадра, см. nextAnimationFrameMs
     bool showMinimapAnimation = level.data().imgui.minimapAnimating;
     bool showLevelScrollAnimation = level.data().imgui.levelScrollAnimating;
     bool showSelectionHighlight = level.data().imgui.showSelectionHighlight;
-    return showLevelAnimation || showMinimapAnimation || showLevelScrollAnimation || showSelectionHighlight;
+    return showMinimapAnimation || showLevelScrollAnimation || showSelectionHighlight;
+}
+
+uint64_t LevelViewer::nextAnimationFrameMs(const Level& level) const
+{
+    return level.data().imgui.showAnimations ? level.data().imgui.nextAnimationFrameMs : 0;
 }
 
 void LevelViewer::drawMenuBar(std::string_view rootDirectory, Level& level)
@@ -468,6 +475,14 @@ bool LevelViewer::isVisibleInWindow(const ImRect& rect) const
     return ImGui::GetCurrentWindow()->ClipRect.Overlaps(rect);
 }
 
+// Видимая часть уровня в координатах уровня. leftMargin расширяет её влево для подписей справа от объектов
+SpatialGrid::Rect LevelViewer::visibleLevelRect(ImVec2 drawPosition, float leftMargin) const
+{
+    const ImRect& clipRect = ImGui::GetCurrentWindow()->ClipRect;
+    return {clipRect.Min.x - drawPosition.x - leftMargin, clipRect.Min.y - drawPosition.y,
+            clipRect.Max.x - drawPosition.x, clipRect.Max.y - drawPosition.y};
+}
+
 bool LevelViewer::leftMouseDownOnLevel(const Level& level) const {
     return !level.data().imgui.minimapHovered &&
            ImGui::IsWindowFocused() &&
@@ -735,8 +750,8 @@ void LevelViewer::drawMinimap(Level& level, const ImRect& levelRect, ImRect& min
                 }
                 if (!isTransition) continue;
 
-                ImVec2 centerPosition(levelRect.Min.x + trigger.lvlDescription.position.x + trigger.texture->w * 0.5f,
-                                      levelRect.Min.y + trigger.lvlDescription.position.y + trigger.texture->h * 0.5f);
+                ImVec2 centerPosition(levelRect.Min.x + trigger.lvlDescription.position.x + trigger.region.w * 0.5f,
+                                      levelRect.Min.y + trigger.lvlDescription.position.y + trigger.region.h * 0.5f);
 
                 ImVec2 minimapPosition = transformPoint(centerPosition, levelRect, minimapRect);
                 drawList->AddCircleFilled(minimapPosition, 3.0f, IM_COL32(0, 140, 248, 255));
@@ -946,101 +961,78 @@ void LevelViewer::drawInfo(Level& level, const ImRect& levelRect, ImVec2 drawPos
     ImGui::TextColored(ImVec4{1.0f, 1.0f, 1.0f, 1.0f}, "%s", infoMessage.c_str());
 }
 
-// Порядок отрисовки чанков и тайлов:
-// [0] [2]
-// [1] [3]
-void LevelViewer::drawMapTiles(Level& level, ImVec2 drawPosition)
+// Оверлей тайлов - текстура с текселем на тайл, растянутая на уровень без фильтрации.
+// Рамка и подсказка тайла под курсором считаются по позиции мыши
+void LevelViewer::drawMapTiles(Level& level, SDL_Renderer* renderer, ImVec2 drawPosition)
 {
     Tracy_ZoneScoped;
-    ImDrawList* drawList = ImGui::GetWindowDrawList();
     const MapTiles& mapTiles = level.data().lvlData.mapTiles;
-    if (mapTiles.chunks.empty()) return;
-
-    ImGui::SetCursorScreenPos(drawPosition);
-
-    const int chunkSize = 2; // 2x2 tiles per chunk
-    const int chunksPerColumn = mapTiles.chunkHeight;
-    const int chunksPerRow = mapTiles.chunkWidth;
-
-    ImVec2 clipMin = ImGui::GetCurrentWindow()->InnerRect.Min;
-    ImVec2 clipMax = ImVec2(clipMin.x + ImGui::GetContentRegionAvail().x,
-                            clipMin.y + ImGui::GetContentRegionAvail().y);
-
-    // Вычисляем диапазон видимых чанков
-    int minVisibleColumn = std::max(0, static_cast<int>((clipMin.x - drawPosition.x) / Level::chunkWidth));
-    int maxVisibleColumn = std::min(chunksPerRow - 1, static_cast<int>((clipMax.x - drawPosition.x) / Level::chunkWidth));
-
-    int minVisibleRow = std::max(0, static_cast<int>((clipMin.y - drawPosition.y) / Level::chunkHeight));
-    int maxVisibleRow = std::min(chunksPerColumn - 1, static_cast<int>((clipMax.y - drawPosition.y) / Level::chunkHeight));
-
-    for (int chunkColumn = minVisibleColumn; chunkColumn <= maxVisibleColumn; ++chunkColumn) {
-        for (int chunkRow = minVisibleRow; chunkRow <= maxVisibleRow; ++chunkRow) {
-            size_t chunkIndex = chunkColumn * chunksPerColumn + chunkRow;
-            const MapChunk& chunk = mapTiles.chunks[chunkIndex];
-
-            bool allSameColor = true;
-            ImU32 firstColor = getTileColor(chunk.front(), level.data().imgui.mapTilesMode);
-            for (size_t i = 1; i < chunk.size(); ++i) {
-                ImU32 color = getTileColor(chunk[i], level.data().imgui.mapTilesMode);
-                if (firstColor != color) {
-                    allSameColor = false;
-                    break;
-                }
-            }
-
-            ImVec2 chunkTopLeft = ImVec2(drawPosition.x + (chunkColumn * Level::chunkWidth),
-                                         drawPosition.y + (chunkRow * Level::chunkHeight));
-
-            if (allSameColor) {
-                ImVec2 chunkBottomRight = ImVec2(chunkTopLeft.x + Level::chunkWidth,
-                                                 chunkTopLeft.y + Level::chunkHeight);
-                drawList->AddRectFilled(chunkTopLeft, chunkBottomRight, firstColor);
-            }
-
-            for (size_t tileIndex = 0; tileIndex < chunk.size(); ++tileIndex) {
-                const MapTile& tile = chunk[tileIndex];
-
-                int tileColumn = chunkColumn * chunkSize + (tileIndex / chunkSize);
-                int tileRow = chunkRow * chunkSize + (tileIndex % chunkSize);
-
-                ImVec2 tileTopLeft = ImVec2(drawPosition.x + (tileColumn * Level::tileWidth),
-                                            drawPosition.y + (tileRow * Level::tileHeight));
-
-                ImVec2 tileBottomRight = ImVec2(tileTopLeft.x + Level::tileWidth,
-                                                tileTopLeft.y + Level::tileHeight);
-
-                if (!allSameColor) {
-                    ImU32 color = getTileColor(tile, level.data().imgui.mapTilesMode);
-                    drawList->AddRectFilled(tileTopLeft, tileBottomRight, color);
-                }
+    if (mapTiles.empty()) return;
+
+    const MapTilesMode mode = level.data().imgui.mapTilesMode;
+    Texture& overlay = level.data().mapTilesOverlays[static_cast<size_t>(mode)];
+    if (!overlay) {
+        std::string error;
+        overlay = createMapTilesOverlay(mapTiles, mode, renderer, &error);
+        if (!overlay) {
+            LogFmt("createMapTilesOverlay error: {}", error);
+            return;
+        }
+    }
 
-                if (level.data().imgui.mapTilesMode == MapTilesMode::Mask && tile.mask != MapTile::kEmptyMask) {
-                    ImGui::SetCursorScreenPos({tileTopLeft.x, tileTopLeft.y});
+    const ImVec2 overlayEnd(drawPosition.x + mapTiles.chunkWidth * Level::chunkWidth,
+                            drawPosition.y + mapTiles.chunkHeight * Level::chunkHeight);
+    ImGui::GetWindowDrawList()->AddImage((ImTextureID)overlay.get(), drawPosition, overlayEnd);
 
-                    ImGui::PushFont(NULL, 10.0f);
-                    ImGui::Text("%u", tile.mask);
-                    ImGui::PopFont();
-                }
+    if (mode == MapTilesMode::Mask) {
+        drawMapTilesMaskValues(mapTiles, drawPosition);
+    }
+    drawHoveredMapTile(level, drawPosition);
+}
 
-                drawTileBorderAndTooltip(tile, tileTopLeft, tileBottomRight, tileColumn, tileRow, chunkColumn, chunkRow, level);
-            }
+// Порядок чанков и тайлов в MapTiles:
+// [0] [2]
+// [1] [3]
+Texture LevelViewer::createMapTilesOverlay(const MapTiles& mapTiles, MapTilesMode mode, SDL_Renderer* renderer, std::string* error)
+{
+    Tracy_ZoneScoped;
+    const std::vector<uint16_t>& plane = (mode == MapTilesMode::Relief) ? mapTiles.relief
+                                       : (mode == MapTilesMode::Sound)  ? mapTiles.sound
+                                                                        : mapTiles.mask;
+
+    const size_t chunksPerColumn = mapTiles.chunkHeight;
+    const size_t width = mapTiles.chunkWidth * 2;
+    const size_t height = mapTiles.chunkHeight * 2;
+    std::vector<ImU32> pixels(width * height);
+    for (size_t index = 0; index < mapTiles.tileCount(); ++index) {
+        const size_t chunkIndex = index / MapTiles::kTilesPerChunk;
+        const size_t tileIndex = index % MapTiles::kTilesPerChunk;
+        const size_t column = (chunkIndex / chunksPerColumn) * 2 + tileIndex / 2;
+        const size_t row = (chunkIndex % chunksPerColumn) * 2 + tileIndex % 2;
+        pixels[row * width + column] = getTileColor(plane[index], mode);
+    }
 
-            drawChunkBorder(chunkTopLeft, level);
-        }
+    // IM_COL32 упакован так же, как SDL_PIXELFORMAT_ABGR8888
+    Texture texture = Texture::create(renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STATIC, (int)width, (int)height, error);
+    if (!texture || !texture.updatePixels(pixels.data(), nullptr, error)) {
+        return {};
     }
+    SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(texture.get(), SDL_SCALEMODE_NEAREST);
+    return texture;
 }
 
-ImU32 LevelViewer::getTileColor(const MapTile& tile, MapTilesMode mode) {
+ImU32 LevelViewer::getTileColor(uint16_t value, MapTilesMode mode) {
     switch (mode) {
         case MapTilesMode::Relief:
-            if (tile.relief <= 1000)        return IM_COL32(0, 255, 0, 64);
-            else if (tile.relief <= 2000)   return IM_COL32(0, 140, 0, 88);
-            else if (tile.relief <= 15000)  return IM_COL32(140, 0, 0, 88);
-            else if (tile.relief <= 35000)  return IM_COL32(180, 0, 0, 96);
-            else if (tile.relief <= 55000)  return IM_COL32(220, 0, 0, 96);
-            else                            return IM_COL32(255, 0, 0, 104);
+            if (value <= 1000)        return IM_COL32(0, 255, 0, 64);
+            else if (value <= 2000)   return IM_COL32(0, 140, 0, 88);
+            else if (value <= 15000)  return IM_COL32(140, 0, 0, 88);
+            else if (value <= 35000)  return IM_COL32(180, 0, 0, 96);
+            else if (value <= 55000)  return IM_COL32(220, 0, 0, 96);
+            else                      return IM_COL32(255, 0, 0, 104);
         case MapTilesMode::Sound:
-            switch (tile.sound) {
+            switch (value) {
                 case MapDataSound::Ground: return IM_COL32(0, 0, 0, 96);
                 case MapDataSound::Grass:  return IM_COL32(0, 204, 0, 96);
                 case MapDataSound::Sand:   return IM_COL32(255, 220, 0, 96);
@@ -1050,52 +1042,92 @@ ImU32 LevelViewer::getTileColor(const MapTile& tile, MapTilesMode mode) {
                 case MapDataSound::Snow:   return IM_COL32(255, 255, 255, 96);
             }
         case MapTilesMode::Mask:
-            return tile.mask == MapTile::kEmptyMask ? IM_COL32(255, 0, 0, 96)
-                                                    : IM_COL32(0, 0, 0, 96);
+            return value == MapTile::kEmptyMask ? IM_COL32(255, 0, 0, 96)
+                                                : IM_COL32(0, 0, 0, 96);
     }
     return IM_COL32(255, 255, 255, 255);
 }
 
-void LevelViewer::drawTileBorderAndTooltip(const MapTile& tile, ImVec2 tileTopLeft, ImVec2 tileBottomRight, int tileColumn, int tileRow, int chunkColumn, int chunkRow, Level& level)
+void LevelViewer::drawMapTilesMaskValues(const MapTiles& mapTiles, ImVec2 drawPosition)
 {
+    Tracy_ZoneScoped;
     ImDrawList* drawList = ImGui::GetWindowDrawList();
 
-    ImVec2 mousePos = ImGui::GetMousePos();
-    if (leftMouseDownOnLevel(level) &&
-        mousePos.x >= tileTopLeft.x && mousePos.x < tileBottomRight.x &&
-        mousePos.y >= tileTopLeft.y && mousePos.y < tileBottomRight.y)
-    {
-        drawList->AddRect(tileTopLeft, tileBottomRight, IM_COL32(255, 255, 0, 255));
-
-        ImGui::SetTooltip("[MAP TILE]\n"
-                          "Tile: %dx%d\n"
-                          "Chunk: %dx%d\n"
-                          "\n"
-                          "Relief: %u\n"
-                          "Sound: %s (%u)\n"
-                          "Mask: %u",
-                          tileColumn, tileRow,
-                          chunkColumn, chunkRow,
-                          tile.relief,
-                          maskSoundToString(static_cast<MapDataSound>(tile.sound)), tile.sound,
-                          tile.mask);
+    ImVec2 clipMin = ImGui::GetCurrentWindow()->InnerRect.Min;
+    ImVec2 clipMax = ImVec2(clipMin.x + ImGui::GetContentRegionAvail().x,
+                            clipMin.y + ImGui::GetContentRegionAvail().y);
+
+    // Только видимые тайлы
+    const int tilesPerRow = mapTiles.chunkWidth * 2;
+    const int tilesPerColumn = mapTiles.chunkHeight * 2;
+    int minVisibleColumn = std::max(0, static_cast<int>((clipMin.x - drawPosition.x) / Level::tileWidth));
+    int maxVisibleColumn = std::min(tilesPerRow - 1, static_cast<int>((clipMax.x - drawPosition.x) / Level::tileWidth));
+
+    int minVisibleRow = std::max(0, static_cast<int>((clipMin.y - drawPosition.y) / Level::tileHeight));
+    int maxVisibleRow = std::min(tilesPerColumn - 1, static_cast<int>((clipMax.y - drawPosition.y) / Level::tileHeight));
+
+    ImFont* font = ImGui::GetFont();
+    const ImU32 textColor = ImGui::GetColorU32(ImGuiCol_Text);
+    char text[8];
+    for (int tileColumn = minVisibleColumn; tileColumn <= maxVisibleColumn; ++tileColumn) {
+        for (int tileRow = minVisibleRow; tileRow <= maxVisibleRow; ++tileRow) {
+            const uint16_t value = mapTiles.mask[mapTiles.tileIndexAt(tileColumn, tileRow)];
+            if (value == MapTile::kEmptyMask)
+                continue;
+
+            ImVec2 tileTopLeft = ImVec2(drawPosition.x + (tileColumn * Level::tileWidth),
+                                        drawPosition.y + (tileRow * Level::tileHeight));
+            const char* textEnd = std::to_chars(text, text + sizeof(text), value).ptr;
+            drawList->AddText(font, 10.0f, tileTopLeft, textColor, text, textEnd);
+        }
     }
 }
 
-void LevelViewer::drawChunkBorder(ImVec2 chunkTopLeft, Level& level)
+void LevelViewer::drawHoveredMapTile(const Level& level, ImVec2 drawPosition)
 {
+    if (!leftMouseDownOnLevel(level))
+        return;
+
+    const MapTiles& mapTiles = level.data().lvlData.mapTiles;
+    const ImVec2 mousePos = ImGui::GetMousePos();
+    if (mousePos.x < drawPosition.x || mousePos.y < drawPosition.y)
+        return;
+
+    const int tileColumn = static_cast<int>((mousePos.x - drawPosition.x) / Level::tileWidth);
+    const int tileRow = static_cast<int>((mousePos.y - drawPosition.y) / Level::tileHeight);
+    if (tileColumn >= (int)mapTiles.chunkWidth * 2 || tileRow >= (int)mapTiles.chunkHeight * 2)
+        return;
+
+    const int chunkColumn = tileColumn / 2;
+    const int chunkRow = tileRow / 2;
+
     ImDrawList* drawList = ImGui::GetWindowDrawList();
 
+    ImVec2 tileTopLeft = ImVec2(drawPosition.x + (tileColumn * Level::tileWidth),
+                                drawPosition.y + (tileRow * Level::tileHeight));
+    ImVec2 tileBottomRight = ImVec2(tileTopLeft.x + Level::tileWidth,
+                                    tileTopLeft.y + Level::tileHeight);
+    drawList->AddRect(tileTopLeft, tileBottomRight, IM_COL32(255, 255, 0, 255));
+
+    ImVec2 chunkTopLeft = ImVec2(drawPosition.x + (chunkColumn * Level::chunkWidth),
+                                 drawPosition.y + (chunkRow * Level::chunkHeight));
     ImVec2 chunkBottomRight = ImVec2(chunkTopLeft.x + Level::chunkWidth,
                                      chunkTopLeft.y + Level::chunkHeight);
-
-    ImVec2 mousePos = ImGui::GetMousePos();
-    if (leftMouseDownOnLevel(level) &&
-        mousePos.x >= chunkTopLeft.x && mousePos.x < chunkBottomRight.x &&
-        mousePos.y >= chunkTopLeft.y && mousePos.y < chunkBottomRight.y)
-    {
-        drawList->AddRect(chunkTopLeft, chunkBottomRight, IM_COL32(255, 228, 0, 180));
-    }
+    drawList->AddRect(chunkTopLeft, chunkBottomRight, IM_COL32(255, 228, 0, 180));
+
+    const MapTile tile = mapTiles.tile(mapTiles.tileIndexAt(tileColumn, tileRow));
+    ImGui::SetTooltip("[MAP TILE]\n"
+                      "Tile: %dx%d\n"
+                      "Chunk: %dx%d\n"
+                      "\n"
+                      "Relief: %u\n"
+                      "Sound: %s (%u)\n"
+                      "Mask: %u",
+                      tileColumn, tileRow,
+                      chunkColumn, chunkRow,
+                      tile.relief,
+                      maskSoundToString(static_cast<MapDataSound>(tile.sound)), tile.sound,
+                      tile.mask);
 }
 
 void LevelViewer::drawPersons(Level& level, ImVec2 drawPosition)
@@ -1104,7 +1136,10 @@ void LevelViewer::drawPersons(Level& level, ImVec2 drawPosition)
     if (level.data().sefData.persons.empty()) { return; }
 
     ImDrawList* drawList = ImGui::GetWindowDrawList();
-    for (const SEF_Person& person : level.data().sefData.persons) {
+    m_visibleObjects.clear();
+    level.data().spatialIndex.persons.query(visibleLevelRect(drawPosition, kLabelMargin), m_visibleObjects);
+    for (uint32_t personIndex : m_visibleObjects) {
+        const SEF_Person& person = level.data().sefData.persons[personIndex];
         ImVec2 position(drawPosition.x + person.position.x * Level::tileWidth,
                         drawPosition.y + person.position.y * Level::tileHeight);
 
@@ -1172,7 +1207,10 @@ void LevelViewer::drawPointsEntrance(Level& level, ImVec2 drawPosition)
 {
     Tracy_ZoneScoped;
     ImDrawList* drawList = ImGui::GetWindowDrawList();
-    for (const SEF_PointEntrance& pointEnt : level.data().sefData.pointsEntrance) {
+    m_visibleObjects.clear();
+    level.data().spatialIndex.pointsEntrance.query(visibleLevelRect(drawPosition, kLabelMargin), m_visibleObjects);
+    for (uint32_t pointIndex : m_visibleObjects) {
+        const SEF_PointEntrance& pointEnt = level.data().sefData.pointsEntrance[pointIndex];
         ImVec2 position(drawPosition.x + pointEnt.position.x * Level::tileWidth,
                         drawPosition.y + pointEnt.position.y * Level::tileHeight);
 
@@ -1226,23 +1264,24 @@ void LevelViewer::drawCellGroups(Level& level, ImVec2 drawPosition)
     bool drawLvl = level.data().imgui.cellGroupMode == CellGroupMode::Both
                    || level.data().imgui.cellGroupMode == CellGroupMode::OnlyLvl;
 
-    int groupIndex = 0;
+    // Пустые группы не попадают в индекс. Группы lvl нумеруются после групп sef
+    const SpatialGrid::Rect visibleRect = visibleLevelRect(drawPosition);
+    const int lvlGroupsOffset = level.data().sefData.cellGroups.size();
     if (drawSef) {
-        for (const CellGroup& group : level.data().sefData.cellGroups) {
-            if (group.cells.empty()) continue;
-
+        m_visibleObjects.clear();
+        level.data().spatialIndex.sefCellGroups.query(visibleRect, m_visibleObjects);
+        for (uint32_t groupIndex : m_visibleObjects) {
+            const CellGroup& group = level.data().sefData.cellGroups[groupIndex];
             drawCellGroup(level.data().imgui, drawPosition, group, groupIndex, SDL_Color{51, 255, 204, 192}, true);
-            ++groupIndex;
         }
     }
 
-    groupIndex = level.data().sefData.cellGroups.size();
     if (drawLvl) {
-        for (const CellGroup& group : level.data().lvlData.cellGroups) {
-            if (group.cells.empty()) continue;
-
-            drawCellGroup(level.data().imgui, drawPosition, group, groupIndex, SDL_Color{40, 200, 200, 192}, false);
-            ++groupIndex;
+        m_visibleObjects.clear();
+        level.data().spatialIndex.lvlCellGroups.query(visibleRect, m_visibleObjects);
+        for (uint32_t groupIndex : m_visibleObjects) {
+            const CellGroup& group = level.data().lvlData.cellGroups[groupIndex];
+            drawCellGroup(level.data().imgui, drawPosition, group, lvlGroupsOffset + groupIndex, SDL_Color{40, 200, 200, 192}, false);
         }
     }
 
@@ -1318,25 +1357,34 @@ void LevelViewer::drawAnimations(Level& level, ImVec2 drawPosition)
 {
     Tracy_ZoneScoped;
     ImDrawList* drawList = ImGui::GetWindowDrawList();
-    bool hasVisibleAnimations = false;
+    uint64_t nextFrameMs = 0;
 
+    // Анимации вне экрана не обновляются, при появлении продолжают с того же кадра
     uint64_t nowMs = SDL_GetTicks();
-    for (LevelAnimation& animation : level.data().animations) {
+    m_visibleObjects.clear();
+    level.data().spatialIndex.animations.query(visibleLevelRect(drawPosition), m_visibleObjects);
+    for (uint32_t animationIndex : m_visibleObjects) {
+        LevelAnimation& animation = level.data().animations[animationIndex];
         animation.update(nowMs);
 
-        if (animation.textures.empty()) { continue; }
+        if (animation.frames.empty()) { continue; }
 
         ImVec2 animationPosition{drawPosition.x + animation.description.position.x,
                                  drawPosition.y + animation.description.position.y};
-        const Texture& texture = animation.currentTexture();
-        ImRect animationBox = {animationPosition, {animationPosition.x + texture->w, animationPosition.y + texture->h}};
+        const TextureRegion& region = animation.currentRegion();
+        ImRect animationBox = {animationPosition, {animationPosition.x + region.w, animationPosition.y + region.h}};
 
         if (!isVisibleInWindow(animationBox)) { continue; }
 
-        hasVisibleAnimations = true;
+        // Кадр из одной картинки не меняется и не требует перерисовки
+        if (animation.frames.size() > 1) {
+            const uint64_t frameTimeMs = animation.nextFrameTimeMs();
+            nextFrameMs = nextFrameMs ? std::min(nextFrameMs, frameTimeMs) : frameTimeMs;
+        }
         ImGui::SetCursorScreenPos(animationPosition);
 
-        ImGui::Image((ImTextureID)texture.get(), ImVec2(texture->w, texture->h));
+        ImGui::Image((ImTextureID)region.texture, ImVec2(region.w, region.h),
+                     ImVec2(region.u0, region.v0), ImVec2(region.u1, region.v1));
 
         if (leftMouseDownOnLevel(level) &&
             animationBox.Contains(ImGui::GetMousePos())) {
@@ -1354,20 +1402,23 @@ void LevelViewer::drawAnimations(Level& level, ImVec2 drawPosition)
                                             animation.description.name.c_str(),
                                             animation.description.position.x, animation.description.position.y,
                                             animation.description.number,
-                                            animation.textures.front()->w, animation.textures.front()->h,
-                                            animation.textures.size(),
+                                            animation.frames.front().w, animation.frames.front().h,
+                                            animation.frames.size(),
                                             animation.delayMs,
                                             animation.description.param1, animation.description.param2);
         }
     }
-    level.data().imgui.hasVisibleAnimations = hasVisibleAnimations;
+    level.data().imgui.nextAnimationFrameMs = nextFrameMs;
 }
 
 void LevelViewer::drawSounds(Level& level, ImVec2 drawPosition)
 {
     Tracy_ZoneScoped;
     ImDrawList* drawList = ImGui::GetWindowDrawList();
-    for (const ExtraSound& sound : level.data().lvlData.sounds.otherSounds) {
+    m_visibleObjects.clear();
+    level.data().spatialIndex.sounds.query(visibleLevelRect(drawPosition), m_visibleObjects);
+    for (uint32_t soundIndex : m_visibleObjects) {
+        const ExtraSound& sound = level.data().lvlData.sounds.otherSounds[soundIndex];
         ImVec2 position(drawPosition.x + sound.chunkPositionX * Level::chunkWidth,
                         drawPosition.y + sound.chunkPositionY * Level::chunkHeight);
         ImRect soundBox = {position, {position.x + Level::chunkWidth, position.y + Level::chunkHeight}};
@@ -1417,10 +1468,13 @@ void LevelViewer::drawTriggers(Level& level, ImVec2 drawPosition)
     Tracy_ZoneScoped;
     ImDrawList* drawList = ImGui::GetWindowDrawList();
 
-    for (const LevelTrigger& trigger : level.data().triggers) {
+    m_visibleObjects.clear();
+    level.data().spatialIndex.triggers.query(visibleLevelRect(drawPosition), m_visibleObjects);
+    for (uint32_t triggerIndex : m_visibleObjects) {
+        const LevelTrigger& trigger = level.data().triggers[triggerIndex];
         ImVec2 triggerPosition{drawPosition.x + trigger.lvlDescription.position.x,
                                drawPosition.y + trigger.lvlDescription.position.y};
-        ImRect triggerBox = {triggerPosition, {triggerPosition.x + trigger.texture->w, triggerPosition.y + trigger.texture->h}};
+        ImRect triggerBox = {triggerPosition, {triggerPosition.x + trigger.region.w, triggerPosition.y + trigger.region.h}};
 
         if (!isVisibleInWindow(triggerBox)) { continue; }
 
@@ -1440,9 +1494,10 @@ void LevelViewer::drawTriggers(Level& level, ImVec2 drawPosition)
 
         ImGui::SetCursorScreenPos(triggerPosition);
         ImVec4 tintColor{1, 1, 1, alpha / 255.0f};
-        ImGui::ImageWithBg((ImTextureID)trigger.texture.get(),
-                           ImVec2(trigger.texture->w, trigger.texture->h),
-                           ImVec2(0, 0), ImVec2(1, 1), {0, 0, 0, 0}, tintColor);
+        ImGui::ImageWithBg((ImTextureID)trigger.region.texture,
+                           ImVec2(trigger.region.w, trigger.region.h),
+                           ImVec2(trigger.region.u0, trigger.region.v0),
+                           ImVec2(trigger.region.u1, trigger.region.v1), {0, 0, 0, 0}, tintColor);
 
         if (leftMouseDownOnLevel(level) &&
             triggerBox.Contains(ImGui::GetMousePos())) {
@@ -1467,7 +1522,7 @@ void LevelViewer::drawTriggers(Level& level, ImVec2 drawPosition)
                             trigger.lvlDescription.name.c_str(),
                             trigger.lvlDescription.position.x, trigger.lvlDescription.position.y,
                             trigger.lvlDescription.number,
-                            trigger.texture->w, trigger.texture->h,
+                            trigger.region.w, trigger.region.h,
                             trigger.lvlDescription.param1, trigger.lvlDescription.param2,
                             isTransition,
                             isVisible,
@@ -7,14 +7,17 @@ class LevelViewer {
 public:
     LevelViewer();
 
-    void update(bool& showWindow, std::string_view rootDirectory, Level& level);
+    void update(bool& showWindow, SDL_Renderer* renderer, std::string_view rootDirectory, Level& level);
     bool isAnimating(const Level& level) const;
+    // Время (SDL_GetTicks) следующего кадра, который нужен анимациям уровня. 0 - не нужен
+    uint64_t nextAnimationFrameMs(const Level& level) const;
 
 private:
     void drawMenuBar(std::string_view rootDirectory, Level& level);
     void handleHotkeys(Level& level, bool anyWindowFocused);
 
     bool isVisibleInWindow(const ImRect& rect) const;
+    SpatialGrid::Rect visibleLevelRect(ImVec2 drawPosition, float leftMargin = 0.0f) const;
     bool leftMouseDownOnLevel(const Level& level) const;
 
     ImVec2 computeMinimapSize(const Level& level, bool hasMinimap);
@@ -31,10 +34,11 @@ private:
     void drawMinimap(Level& level, const ImRect& levelRect, ImRect& minimapRect);
     void drawInfo(Level& level, const ImRect& levelRect, ImVec2 drawPosition);
 
-    void drawMapTiles(Level& level, ImVec2 drawPosition);
-    ImU32 getTileColor(const MapTile& tile, MapTilesMode mode);
-    void drawTileBorderAndTooltip(const MapTile& tile, ImVec2 tileTopLeft, ImVec2 tileBottomRight, int tileColumn, int tileRow, int chunkColumn, int chunkRow, Level& level);
-    void drawChunkBorder(ImVec2 chunkTopLeft, Level& level);
+    void drawMapTiles(Level& level, SDL_Renderer* renderer, ImVec2 drawPosition);
+    Texture createMapTilesOverlay(const MapTiles& mapTiles, MapTilesMode mode, SDL_Renderer* renderer, std::string* error);
+    ImU32 getTileColor(uint16_t value, MapTilesMode mode);
+    void drawMapTilesMaskValues(const MapTiles& mapTiles, ImVec2 drawPosition);
+    void drawHoveredMapTile(const Level& level, ImVec2 drawPosition);
 
     void drawPersons(Level& level, ImVec2 drawPosition);
     void drawPointsEntrance(Level& level, ImVec2 drawPosition);
@@ -45,4 +49,9 @@ private:
     void drawTriggers(Level& level, ImVec2 drawPosition);
 
     void drawObjectsList(Level& level);
+
+    // Запас слева при отборе персонажей и точек входа: их подписи рисуются справа от клетки
+    static constexpr float kLabelMargin = 512.0f;
+
+    std::vector<uint32_t> m_visibleObjects; // Результат запроса к LevelSpatialIndex, общий для всех слоёв
 };
@@ -72,7 +72,7 @@ bool MdfViewer::isAnimating() const {
     return m_playAnimation && !m_animationLayers.empty();
 }
 
-void MdfViewer::update(bool& showWindow, SDL_Renderer* renderer, std::string_view rootDirectory, const std::vector<std::string>& mdfFiles)
+void MdfViewer::update(bool& showWindow, SDL_Renderer* renderer, TextureCache& textureCache, std::string_view rootDirectory, const std::vector<std::string>& mdfFiles)
 {
     Tracy_ZoneScoped;
 
@@ -104,11 +104,12 @@ void MdfViewer::update(bool& showWindow, SDL_Renderer* renderer, std::string_vie
                         m_selectedIndex = i;
 
                         m_animationCurrentTime = 0;
-                        m_animationLoader.clear();
                         m_uiError.clear();
                         m_mdfDataInfo.clear();
                         m_animationLayers.clear();
                         m_layerInfos.clear();
+                        // Анимации предыдущего файла больше не используются, недавние удерживает общий кэш
+                        m_animationTextures.clear();
 
                         auto mdfDataOpt = MDF_Parser::parse(std::format("{}/{}", rootDirectory, mdfFiles[i]), &m_uiError);
                         if (mdfDataOpt) {
@@ -144,24 +145,26 @@ void MdfViewer::update(bool& showWindow, SDL_Renderer* renderer, std::string_vie
                                     std::string animationPath = std::format("{}/magic/bitmap/{}", rootDirectory, animDesc.animationPath);
                                     SDL_Color transparentColor = {255, 0, 255, 255};
 
-                                    const std::vector<Texture>* textures
-                                            = m_animationLoader.load(animationPath,
-                                                                     [&]() -> std::optional<std::vector<Texture>> {
-                                                                         std::vector<Texture> result;
-                                                                         if (!TextureLoader::loadCountAnimationFromFile(animationPath,
-                                                                             animDesc.framesCount,
-                                                                             renderer,
-                                                                             result,
-                                                                             (animDesc.maskAnimationPath.empty() ? &transparentColor : nullptr),
-                                                                             &m_uiError))
-                                                                         {
-                                                                             return std::nullopt;
-                                                                         }
-                                                                         return std::move(result);
-                                                                     });
+                                    const bool useTransparentColor = animDesc.maskAnimationPath.empty();
+                                    TextureHandle textures = textureCache.load(animationPath,
+                                                                               std::format("count={} colorkey={}", animDesc.framesCount, useTransparentColor),
+                                                                               [&]() -> std::optional<TextureSet> {
+                                                                                   TextureSet result;
+                                                                                   if (!TextureLoader::loadCountAnimationFromFile(animationPath,
+                                                                                       animDesc.framesCount,
+                                                                                       renderer,
+                                                                                       result,
+                                                                                       (useTransparentColor ? &transparentColor : nullptr),
+                                                                                       &m_uiError))
+                                                                                   {
+                                                                                       return std::nullopt;
+                                                                                   }
+                                                                                   return std::move(result);
+                                                                               });
                                     if (!textures) break;
 
                                     animation.setTextures(*textures);
+                                    m_animationTextures.push_back(std::move(textures));
 
                                     layerInfo.animationInfo[animationIndex].width = animation.width();
                                     layerInfo.animationInfo[animationIndex].height = animation.height();
@@ -338,10 +341,10 @@ void MdfViewer::update(bool& showWindow, SDL_Renderer* renderer, std::string_vie
     // Очистка
     if (!showWindow && !m_onceWhenClose) {
         m_selectedIndex = -1;
-        m_animationLoader.clear();
         m_animationCurrentTime = 0;
         m_animationLayers.clear();
         m_layerInfos.clear();
+        m_animationTextures.clear();
         m_uiError.clear();
         m_textFilter.Clear();
         m_bgTexture = {};
@@ -6,9 +6,9 @@
 #include "imgui.h"
 
 #include "graphics/TimedAnimation.h"
+#include "graphics/TextureCache.h"
 #include "graphics/Texture.h"
 #include "parsers/MDF_Parser.h"
-#include "Cache.h"
 
 struct SDL_Renderer;
 
@@ -16,7 +16,7 @@ class MdfViewer {
 public:
     MdfViewer();
 
-    void update(bool& showWindow, SDL_Renderer* renderer, std::string_view rootDirectory, const std::vector<std::string>& mdfFiles);
+    void update(bool& showWindow, SDL_Renderer* renderer, TextureCache& textureCache, std::string_view rootDirectory, const std::vector<std::string>& mdfFiles);
     bool isAnimating() const;
 
 private:
@@ -77,7 +77,7 @@ private:
     std::string mdfInfoString(const MDF_Data& data);
 
     int m_selectedIndex = -1;
-    Cache<std::vector<Texture>> m_animationLoader;
+    std::vector<TextureHandle> m_animationTextures; // Текстуры текущего файла. Повторно используются через общий TextureCache
     std::vector<std::vector<MagicAnimation>> m_animationLayers;
     std::vector<LayerInfo> m_layerInfos;
     std::string m_mdfDataInfo;
@@ -0,0 +1,135 @@
+#include "TelemetryViewer.h"
+
+#include <algorithm>
+#include <string>
+
+#include <SDL3/SDL_dialog.h>
+
+#include "utils/TracyProfiler.h"
+#include "utils/FileUtils.h"
+#include "utils/DebugLog.h"
+
+TelemetryViewer::TelemetryViewer() {}
+
+void TelemetryViewer::update(bool& showWindow, SDL_Window* window)
+{
+    if (!showWindow) return;
+
+    ImGui::SetNextWindowSize(ImVec2(720, 420), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Telemetry", &showWindow)) {
+        ImGui::End();
+        return;
+    }
+
+    if (!m_paused) {
+        m_stats = Telemetry::stats();
+    }
+
+    ImGui::Checkbox("Pause", &m_paused);
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) {
+        Telemetry::reset();
+        m_stats.clear();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export CSV...")) {
+        showExportDialog(window, ExportFormat::Csv);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export JSON...")) {
+        showExportDialog(window, ExportFormat::Json);
+    }
+    ImGui::SameLine();
+    ImGui::TextDisabled("Dropped: %llu", (unsigned long long)Telemetry::droppedEvents());
+
+    m_textFilter.Draw("Filter");
+
+    // p50/p95 по последним Telemetry::kPercentileWindow замерам зоны, остальное за всё время
+    const ImGuiTableFlags tableFlags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+                                       ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable | ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("TelemetryTable", 7, tableFlags)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Zone", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("Last, ms");
+        ImGui::TableSetupColumn("p50, ms");
+        ImGui::TableSetupColumn("p95, ms", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+        ImGui::TableSetupColumn("Max, ms");
+        ImGui::TableSetupColumn("Total, ms");
+        ImGui::TableHeadersRow();
+
+        sortStats(ImGui::TableGetSortSpecs());
+
+        for (const Telemetry::ZoneStats& zone : m_stats) {
+            if (!m_textFilter.PassFilter(zone.name.c_str())) continue;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(zone.name.c_str());
+            ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)zone.count);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", zone.lastMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", zone.p50Ms);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", zone.p95Ms);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", zone.maxMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", zone.totalMs);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+void TelemetryViewer::sortStats(const ImGuiTableSortSpecs* sortSpecs)
+{
+    if (!sortSpecs || sortSpecs->SpecsCount == 0) return;
+
+    const ImGuiTableColumnSortSpecs& spec = sortSpecs->Specs[0];
+    auto key = [column = spec.ColumnIndex] (const Telemetry::ZoneStats& zone) -> double {
+        switch (column) {
+            case 1: return (double)zone.count;
+            case 2: return zone.lastMs;
+            case 3: return zone.p50Ms;
+            case 4: return zone.p95Ms;
+            case 5: return zone.maxMs;
+            case 6: return zone.totalMs;
+        }
+        return 0.0;
+    };
+    const bool ascending = spec.SortDirection == ImGuiSortDirection_Ascending;
+    std::stable_sort(m_stats.begin(), m_stats.end(), [&] (const Telemetry::ZoneStats& a, const Telemetry::ZoneStats& b) {
+        if (spec.ColumnIndex == 0) {
+            return ascending ? a.name < b.name : b.name < a.name;
+        }
+        return ascending ? key(a) < key(b) : key(b) < key(a);
+    });
+}
+
+void TelemetryViewer::showExportDialog(SDL_Window* window, ExportFormat format)
+{
+    static const SDL_DialogFileFilter csvFilter = {"CSV", "csv"};
+    static const SDL_DialogFileFilter jsonFilter = {"JSON", "json"};
+
+    m_exportFormat = format;
+    const bool isCsv = (format == ExportFormat::Csv);
+    SDL_ShowSaveFileDialog([] (void* userdata, const char* const* filelist, int /*filter*/) {
+        TelemetryViewer* self = static_cast<TelemetryViewer*>(userdata);
+        if (!filelist) {
+            LogFmt("Save dialog error: {}", SDL_GetError());
+            return;
+        } else if (!*filelist) {
+            Log("Dialog was canceled");
+            return;
+        } else if ((*filelist)[0] == '\0') {
+            Log("Filelist empty");
+            return;
+        }
+
+        // Диалог может вызвать обработчик из другого потока, Telemetry::stats потокобезопасен
+        std::vector<Telemetry::ZoneStats> stats = Telemetry::stats();
+        std::string text = (self->m_exportFormat == ExportFormat::Csv) ? Telemetry::toCsv(stats)
+                                                                       : Telemetry::toJson(stats);
+        std::string error;
+        if (!FileUtils::saveFile(*filelist, {(const uint8_t*)text.data(), text.size()}, &error)) {
+            LogFmt("FileUtils::saveFile error: {}", error);
+        }
+    }, this, window, isCsv ? &csvFilter : &jsonFilter, 1, isCsv ? "telemetry.csv" : "telemetry.json");
+}
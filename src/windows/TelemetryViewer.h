@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+
+#include "imgui.h"
+
+#include "utils/Telemetry.h"
+
+struct SDL_Window;
+
+class TelemetryViewer {
+public:
+    TelemetryViewer();
+
+    void update(bool& showWindow, SDL_Window* window);
+
+private:
+    enum class ExportFormat {
+        Csv,
+        Json
+    };
+
+    void sortStats(const ImGuiTableSortSpecs* sortSpecs);
+    void showExportDialog(SDL_Window* window, ExportFormat format);
+
+    std::vector<Telemetry::ZoneStats> m_stats;
+    ImGuiTextFilter m_textFilter;
+    ExportFormat m_exportFormat = ExportFormat::Csv;
+    bool m_paused = false;
+};
@@ -0,0 +1,250 @@
+#pragma once
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "enums/CsOpcodes.h"
+#include "CsExecutor.h"
+
+namespace {
+
+// Случайные скрипты из целочисленных переменных: присваивания, +, -, * на {-1, 0, 1},
+// сравнения, && и ||, переходы вперёд и назад. Циклы допустимы: их обрывает защита от бесконечного выполнения
+class CsScriptGenerator
+{
+public:
+    static constexpr int kVariablesCount = 4;
+
+    explicit CsScriptGenerator(uint32_t seed) : m_random(seed) {}
+
+    std::vector<CS_Node> generate() {
+        m_nodes.clear();
+        m_statementsCount = 2 + random(20);
+        m_nodes.resize(m_statementsCount);
+
+        for (int i = 0; i < m_statementsCount; ++i) {
+            CS_Node statement;
+            const int kind = random(10);
+            if (kind < 4) {
+                statement = m_nodes[condition(0)]; // Условие само становится инструкцией
+                statement.c = target();
+                statement.d = target();
+            } else if (kind < 7) {
+                statement.opcode = kAssign;
+                statement.a = variable();
+                const int value = random(3);
+                statement.b = value == 0 ? variable() : value == 1 ? number(random(5) - 2) : arithmetic();
+                statement.d = target();
+            } else if (kind < 9) {
+                statement.opcode = kJmp;
+                statement.c = target();
+                statement.d = 0;
+            } else {
+                statement.opcode = kJmp;
+                statement.d = -1;
+            }
+            m_nodes[i] = statement;
+        }
+        return m_nodes;
+    }
+
+    static std::string variableName(int index) {
+        return "v" + std::to_string(index);
+    }
+
+private:
+    int random(int count) {
+        return std::uniform_int_distribution<int>(0, count - 1)(m_random);
+    }
+
+    int add(const CS_Node& node) {
+        m_nodes.push_back(node);
+        return static_cast<int>(m_nodes.size()) - 1;
+    }
+
+    int variable() {
+        CS_Node node;
+        node.opcode = kStringVarName;
+        node.text = variableName(random(kVariablesCount));
+        return add(node);
+    }
+
+    int number(int value) {
+        CS_Node node;
+        node.opcode = kNumberLiteral;
+        node.value = value;
+        return add(node);
+    }
+
+    // Правый операнд из {-1, 0, 1}: значения не выходят за int даже в цикле до kStopCounter
+    int arithmetic() {
+        CS_Node node;
+        node.opcode = 14 + random(3);
+        node.a = variable();
+        node.b = number(random(3) - 1);
+        return add(node);
+    }
+
+    int comparison() {
+        CS_Node node;
+        node.opcode = 6 + random(6);
+        node.a = variable();
+        const int rhs = random(3);
+        node.b = rhs == 0 ? variable() : rhs == 1 ? number(random(5) - 2) : arithmetic();
+        return add(node);
+    }
+
+    int condition(int depth) {
+        if (depth < 3 && random(3) == 0) {
+            CS_Node node;
+            node.opcode = random(2) ? kLogicOr : kLogicAnd;
+            node.a = condition(depth + 1);
+            node.b = condition(depth + 1);
+            return add(node);
+        }
+        return comparison();
+    }
+
+    int target() {
+        return random(m_statementsCount);
+    }
+
+    std::mt19937 m_random;
+    std::vector<CS_Node> m_nodes;
+    int m_statementsCount = 0;
+};
+
+// Эталон: разбор узлов при каждом выполнении, как в исходном интерпретаторе CsExecutor.
+// Поддерживает только то, что порождает CsScriptGenerator
+class CsReferenceInterpreter
+{
+public:
+    enum Status { kEnd, kInfinity };
+
+    CsReferenceInterpreter(const std::vector<CS_Node>& nodes, std::map<std::string, int32_t> vars) :
+        m_nodes(nodes),
+        m_vars(std::move(vars)),
+        m_covered(nodes.size(), false)
+    {}
+
+    Status run() {
+        int counter = 0;
+        int index = 0;
+        while (true) {
+            if (counter >= 10000)
+                return kInfinity;
+            ++counter;
+
+            const CS_Node& node = m_nodes[index];
+            m_covered[index] = true;
+            if (node.opcode == kJmp) {
+                if (node.d == -1)
+                    return kEnd;
+                index = node.c;
+            } else if (node.opcode == kAssign) {
+                m_covered[node.a] = true;
+                m_vars[m_nodes[node.a].text] = value(node.b);
+                index = node.d;
+            } else {
+                index = condition(index) ? node.c : node.d;
+            }
+        }
+    }
+
+    const std::map<std::string, int32_t>& vars() const { return m_vars; }
+    const std::vector<bool>& covered() const { return m_covered; }
+
+private:
+    bool condition(int index) {
+        const CS_Node& node = m_nodes[index];
+        m_covered[index] = true;
+        if (node.opcode == kLogicOr || node.opcode == kLogicAnd) {
+            // Обе части вычисляются всегда
+            const bool lhs = condition(node.a);
+            const bool rhs = condition(node.b);
+            return node.opcode == kLogicOr ? lhs || rhs : lhs && rhs;
+        }
+
+        const int32_t lhs = value(node.a);
+        const int32_t rhs = value(node.b);
+        switch (node.opcode) {
+            case 6: return lhs != rhs;
+            case 7: return lhs == rhs;
+            case 8: return lhs >= rhs;
+            case 9: return lhs <= rhs;
+            case 10: return lhs > rhs;
+            case 11: return lhs < rhs;
+        }
+        ADD_FAILURE() << "Unexpected opcode " << node.opcode;
+        return false;
+    }
+
+    int32_t value(int index) {
+        const CS_Node& node = m_nodes[index];
+        m_covered[index] = true;
+        switch (node.opcode) {
+            case kStringVarName: return m_vars.at(node.text);
+            case kNumberLiteral: return static_cast<int32_t>(node.value);
+            case 14: return value(node.a) + value(node.b);
+            case 15: return value(node.a) - value(node.b);
+            case 16: return value(node.a) * value(node.b);
+        }
+        ADD_FAILURE() << "Unexpected opcode " << node.opcode;
+        return 0;
+    }
+
+    const std::vector<CS_Node>& m_nodes;
+    std::map<std::string, int32_t> m_vars;
+    std::vector<bool> m_covered;
+};
+
+} // namespace
+
+TEST(CsExecutor, MatchesReferenceInterpreter) {
+    constexpr int kScriptsCount = 3000;
+    constexpr int kRunsCount = 2; // Второй запуск после restart(false) продолжает с изменёнными переменными
+
+    for (int seed = 0; seed < kScriptsCount; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        CsScriptGenerator generator(seed);
+        const std::vector<CS_Node> nodes = generator.generate();
+
+        std::mt19937 random(seed);
+        StringHashTable<AgeVariable_t> globalVars;
+        std::map<std::string, int32_t> referenceVars;
+        for (int i = 0; i < CsScriptGenerator::kVariablesCount; ++i) {
+            const int32_t value = std::uniform_int_distribution<int32_t>(-3, 3)(random);
+            globalVars.emplace(CsScriptGenerator::variableName(i), value);
+            referenceVars.emplace(CsScriptGenerator::variableName(i), value);
+        }
+
+        CsExecutor executor(nodes, globalVars);
+        CsReferenceInterpreter reference(nodes, referenceVars);
+        for (int run = 0; run < kRunsCount; ++run) {
+            if (run > 0) {
+                executor.restart(false);
+            }
+            while (executor.next()) {}
+
+            const CsReferenceInterpreter::Status status = reference.run();
+            ASSERT_EQ(executor.currentStatus(), status == CsReferenceInterpreter::kEnd ? CsExecutor::kEnd : CsExecutor::kInfinity);
+
+            // У исполнителя только переменные, которые встречаются в скрипте (и LastPhrase, LastAnswer после restart)
+            for (const auto& [name, value] : reference.vars()) {
+                auto it = executor.scriptVars().find(name);
+                if (it == executor.scriptVars().end()) {
+                    EXPECT_EQ(value, std::get<int32_t>(globalVars.at(name))) << name;
+                    continue;
+                }
+                ASSERT_TRUE(std::holds_alternative<int32_t>(it->second)) << name;
+                EXPECT_EQ(std::get<int32_t>(it->second), value) << name;
+            }
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                ASSERT_EQ(executor.isNodeExecuted(i), reference.covered()[i]) << "node " << i;
+            }
+        }
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "parsers/CSX_Parser.h"
+
+namespace {
+
+// Случайное изображение CSX: серии обычных цветов (в том числе длиннее 32 байт, чтобы работали
+// векторные ветки), экранирование, одиночные прозрачные пиксели и оба вида заполнения
+std::vector<uint8_t> generateCsx(uint32_t seed, uint32_t width, uint32_t height)
+{
+    std::mt19937 random(seed);
+    auto randomInt = [&random] (int count) {
+        return std::uniform_int_distribution<int>(0, count - 1)(random);
+    };
+    auto literalColor = [&randomInt] () {
+        uint8_t color;
+        do {
+            color = static_cast<uint8_t>(randomInt(256));
+        } while (color >= 0x69 && color <= 0x6C);
+        return color;
+    };
+
+    std::vector<uint8_t> bytes;
+    std::vector<uint32_t> lineOffsets = {0};
+    for (uint32_t y = 0; y < height; ++y) {
+        uint32_t x = 0;
+        while (true) { // В начале итерации x < width
+            const uint32_t left = width - x;
+            const int command = randomInt(6);
+            if (command < 2) {
+                const uint32_t count = std::min<uint32_t>(left, 1 + randomInt(command == 0 ? 8 : 100));
+                for (uint32_t i = 0; i < count; ++i) {
+                    bytes.push_back(literalColor());
+                }
+                x += count;
+            } else if (command == 2) {
+                bytes.push_back(0x6B);
+                bytes.push_back(static_cast<uint8_t>(0x69 + randomInt(4)));
+                x += 1;
+            } else if (command == 3) {
+                bytes.push_back(0x69);
+                x += 1;
+            } else if (command == 4) {
+                const uint32_t count = std::min<uint32_t>(left, randomInt(256));
+                bytes.push_back(0x6A);
+                bytes.push_back(static_cast<uint8_t>(randomInt(256)));
+                bytes.push_back(static_cast<uint8_t>(count));
+                x += count;
+            } else {
+                const uint32_t count = std::min<uint32_t>(left, randomInt(256));
+                bytes.push_back(0x6C);
+                bytes.push_back(static_cast<uint8_t>(count));
+                x += count;
+            }
+            if (x == width || randomInt(16) == 0) break;
+        }
+        lineOffsets.push_back(static_cast<uint32_t>(bytes.size()));
+    }
+
+    std::vector<uint8_t> file;
+    auto writeUInt32 = [&file] (uint32_t value) {
+        const size_t offset = file.size();
+        file.resize(offset + sizeof(value));
+        std::memcpy(file.data() + offset, &value, sizeof(value));
+    };
+
+    constexpr uint32_t kColorCount = 16;
+    writeUInt32(kColorCount);
+    writeUInt32(0x00FF00FF); // Цвет заливки не входит в палитру
+    for (uint32_t i = 0; i < kColorCount; ++i) {
+        writeUInt32(i * 0x00101010);
+    }
+    writeUInt32(width);
+    writeUInt32(height);
+    for (uint32_t offset : lineOffsets) {
+        writeUInt32(offset);
+    }
+    file.insert(file.end(), bytes.begin(), bytes.end());
+    return file;
+}
+
+// Эталон: разбор по одному байту, как до векторизации
+void referenceDecodeLine(std::span<const uint8_t> bytes, size_t byteIndex, std::span<uint8_t> pixels, size_t pixelIndex, size_t byteCount)
+{
+    while (byteCount > 0) {
+        uint8_t x = bytes[byteIndex];
+        byteIndex++;
+        byteCount--;
+
+        switch (x) {
+            case 107: {
+                pixels[pixelIndex] = bytes[byteIndex];
+                byteIndex++;
+                byteCount--;
+                pixelIndex++;
+                break;
+            }
+            case 105: {
+                pixelIndex++;
+                break;
+            }
+            case 106: {
+                auto runLength = bytes[byteIndex + 1];
+                uint8_t colorIndex = bytes[byteIndex];
+                std::fill_n(pixels.begin() + pixelIndex, runLength, colorIndex);
+                byteCount -= 2;
+                byteIndex += 2;
+                pixelIndex += runLength;
+                break;
+            }
+            case 108: {
+                auto runLength = bytes[byteIndex];
+                byteIndex++;
+                byteCount--;
+                pixelIndex += runLength;
+                break;
+            }
+            default: {
+                pixels[pixelIndex] = x;
+                pixelIndex++;
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(CsxParser, DecodeMatchesReference) {
+    constexpr int kImagesCount = 20;
+    constexpr uint32_t kWidth = 300;
+    constexpr uint32_t kHeight = 1000; // 20000 строк всего
+
+    for (int seed = 0; seed < kImagesCount; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        const std::vector<uint8_t> file = generateCsx(seed, kWidth, kHeight);
+
+        CSX_Parser parser(file);
+        ASSERT_TRUE(parser.preParse());
+        const CsxMetaInfo& metaInfo = parser.metaInfo();
+        ASSERT_EQ(metaInfo.width, kWidth);
+        ASSERT_EQ(metaInfo.height, kHeight);
+
+        // Шаг строки больше ширины: лишние байты должны остаться цветом заливки
+        const size_t pitch = kWidth + 13;
+        std::vector<uint8_t> pixels(pitch * kHeight);
+        parser.parseLines(pixels, pitch, true, 0, kHeight);
+
+        std::vector<uint8_t> expected(pitch * kHeight, static_cast<uint8_t>(metaInfo.fillColorIndex));
+        for (uint32_t y = 0; y < kHeight; ++y) {
+            referenceDecodeLine(metaInfo.bytes, metaInfo.lineOffsets[y], expected, y * pitch,
+                                metaInfo.lineOffsets[y + 1] - metaInfo.lineOffsets[y]);
+        }
+        ASSERT_EQ(pixels, expected);
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include "enums/CsFunctions.h"
+#include "enums/CsOpcodes.h"
+#include "utils/DialogTests.h"
+#include "CsExecutor.h"
+
+namespace {
+
+// Полное двоичное дерево диалога глубины depth. Реплика p спрашивает D_Say(p) и предлагает
+// ответы 2p и 2p+1, следующий запуск выбирает реплику по LastAnswer. Листья дерева пустые.
+// Все узлы достижимы, но только если перебирать оба ответа в каждой реплике
+std::vector<CS_Node> dialogTreeNodes(int depth)
+{
+    constexpr int kEqual = 7;
+    const int phrasesCount = (1 << depth) - 1;
+
+    std::vector<CS_Node> nodes;
+    auto add = [&nodes] (CS_Node node) {
+        nodes.push_back(std::move(node));
+        return static_cast<int>(nodes.size()) - 1;
+    };
+    auto variable = [&add] (const char* name) {
+        CS_Node node;
+        node.opcode = kStringVarName;
+        node.text = name;
+        return add(node);
+    };
+    auto number = [&add] (double value) {
+        CS_Node node;
+        node.opcode = kNumberLiteral;
+        node.value = value;
+        return add(node);
+    };
+
+    // Цепочка сравнений: if (LastAnswer == p) { ... } else следующая реплика
+    std::vector<int> compareNodes(phrasesCount + 1);
+    for (int phrase = 1; phrase <= phrasesCount; ++phrase) {
+        CS_Node compare;
+        compare.opcode = kEqual;
+        compareNodes[phrase] = add(compare);
+        const int lhs = variable("LastAnswer");
+        const int rhs = number(phrase == 1 ? 0 : phrase);
+        nodes[compareNodes[phrase]].a = lhs;
+        nodes[compareNodes[phrase]].b = rhs;
+    }
+
+    CS_Node stop;
+    stop.opcode = kJmp;
+    stop.c = 0;
+    stop.d = -1;
+    const int stopNode = add(stop);
+
+    for (int phrase = 1; phrase <= phrasesCount; ++phrase) {
+        nodes[compareNodes[phrase]].d = phrase < phrasesCount ? compareNodes[phrase + 1] : stopNode;
+        if (2 * phrase > phrasesCount) {
+            nodes[compareNodes[phrase]].c = stopNode;
+            continue;
+        }
+
+        // tmp = D_Say(p); tmp = D_Answer(2p); tmp = D_Answer(2p + 1)
+        int previous = -1;
+        const std::pair<uint32_t, int> calls[] = {{kD_Say, phrase}, {kD_Answer, 2 * phrase}, {kD_Answer, 2 * phrase + 1}};
+        for (auto [func, argument] : calls) {
+            CS_Node assign;
+            assign.opcode = kAssign;
+            const int assignNode = add(assign);
+            const int target = variable("tmp");
+            CS_Node call;
+            call.opcode = kFunc;
+            call.value = func;
+            const int callNode = add(call);
+            const int argumentNode = number(argument);
+            nodes[callNode].args = {argumentNode, -1, -1, -1, -1, -1, -1, -1, -1};
+            nodes[assignNode].a = target;
+            nodes[assignNode].b = callNode;
+
+            if (previous == -1) {
+                nodes[compareNodes[phrase]].c = assignNode;
+            } else {
+                nodes[previous].d = assignNode;
+            }
+            previous = assignNode;
+        }
+        nodes[previous].d = stopNode;
+    }
+    return nodes;
+}
+
+StringHashTable<AgeVariable_t> dialogTreeGlobals()
+{
+    return {{"LastAnswer", 0u}, {"LastPhrase", 0u}, {"tmp", 0}};
+}
+
+} // namespace
+
+TEST(ExploreDialog, CoversWholeTree) {
+    const std::vector<CS_Node> nodes = dialogTreeNodes(9);
+    CsExecutor executor(nodes, dialogTreeGlobals());
+
+    DialogExploreResult result = exploreDialog(executor);
+    EXPECT_FALSE(result.isLimitReached);
+    EXPECT_EQ(result.infinityPaths, 0u);
+    EXPECT_EQ(executor.coverage().count(), nodes.size());
+    EXPECT_FLOAT_EQ(executor.executedPercent(), 100.0f);
+}
+
+TEST(ExploreDialog, RevisitedStatesAreSkipped) {
+    const std::vector<CS_Node> nodes = dialogTreeNodes(4);
+    CsExecutor executor(nodes, dialogTreeGlobals());
+
+    DialogExploreResult result = exploreDialog(executor);
+    EXPECT_FALSE(result.isLimitReached);
+    EXPECT_GT(result.skippedStates, 0u);
+    EXPECT_EQ(executor.coverage().count(), nodes.size());
+}
+
+TEST(ExploreDialog, StopsAtStateLimit) {
+    const std::vector<CS_Node> nodes = dialogTreeNodes(9);
+    CsExecutor executor(nodes, dialogTreeGlobals());
+
+    DialogExploreResult result = exploreDialog(executor, 16);
+    EXPECT_TRUE(result.isLimitReached);
+    EXPECT_EQ(result.states, 16u);
+    EXPECT_LT(executor.coverage().count(), nodes.size());
+}
@@ -101,3 +101,24 @@ TEST(NaturalCompare, Gold2) {
     std::sort(data.begin(), data.end(), StringUtils::naturalCompare);
     EXPECT_EQ(data, result);
 }
+
+TEST(DecodeWin1251, MixedBlocks) {
+    // Длинный ASCII-участок (несколько SIMD-блоков), затем кириллица и снова ASCII
+    std::string ascii(70, 'a');
+    std::string input = ascii + "\xCF\xF0\xE8\xE2\xE5\xF2, \\world\xB9" + ascii;
+    std::string expected = ascii + "Привет, \\world№" + ascii;
+    EXPECT_EQ(StringUtils::decodeWin1251ToUtf8(input), expected);
+}
+
+TEST(DecodeWin1251, XorKey) {
+    std::string plain = std::string(40, ' ') + "\xC4\xE0 Yes";
+    std::string encrypted = plain;
+    for (char& c : encrypted) {
+        c ^= 0xAA;
+    }
+
+    char buffer[256];
+    size_t size = StringUtils::decodeWin1251ToUtf8Buffer(encrypted, buffer, 0xAA);
+    EXPECT_EQ(std::string_view(buffer, size), std::string(40, ' ') + "Да Yes");
+    EXPECT_EQ(buffer[size], '\0');
+}
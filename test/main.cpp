@@ -1 +1,4 @@
 #include "StringUtilsTest.h"
+#include "DialogExplorerTest.h"
+#include "CsExecutorTest.h"
+#include "CsxParserTest.h"